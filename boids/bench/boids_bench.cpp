@@ -0,0 +1,495 @@
+#include <cmath>
+#include <cfloat>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+
+#include "flock.h"
+#include "utils.h"
+#include "steering.h"
+#include "random.h"
+#include "spatial_hash.h"
+#include "shard.h"
+#include "compact_flock.h"
+
+// Usage : boids_bench [boids] [steps] [seed] [threads] [float|compact|shards|simd]
+// En mode shards, threads donne le nombre de processus ; code de retour non
+// nul si l'écart au chemin en un processus après un pas dépasse TOLERANCE_SHARDS
+// En mode compact, code de retour non nul si l'écart après un pas dépasse la quantification
+// En mode simd et float, code de retour non nul si un noyau s'écarte du
+// scalaire de plus que la borne d'arrondi de borne_simd
+// Sortie CSV sur stdout, sans fenêtre
+
+static double percentile(std::vector<double> valeurs, double p) {
+
+    if (valeurs.empty()) return 0.0;
+
+    size_t rang = static_cast<size_t>(p * (valeurs.size() - 1) + 0.5);
+    std::nth_element(valeurs.begin(), valeurs.begin() + rang, valeurs.end());
+    return valeurs[rang];
+
+}
+
+// Les noyaux calculent chaque terme par les mêmes opérations flottantes ;
+// seul l'ordre des sommes change. Une somme flottante de n termes reste à
+// (n - 1) u Σ|terme| de la somme exacte quel que soit l'ordre, et normalize
+// amplifie un écart e sur un vecteur de norme m d'au plus 2 e / (m - e).
+// D'où une borne par voisinage, relative aux sommes accumulées, plafonnée
+// à 2 FORCE_MAX poids par règle (deux directions opposées)
+constexpr double U = FLT_EPSILON / 2;
+
+struct Somme {
+
+    double x = 0, y = 0, abs_x = 0, abs_y = 0, n = 0;
+
+    void ajouter(float tx, float ty) {
+
+        x += tx;
+        y += ty;
+        abs_x += std::fabs(tx);
+        abs_y += std::fabs(ty);
+        n += 1;
+
+    }
+
+};
+
+// Écart maximal entre deux noyaux pour une règle dont la force est
+// normalize(somme / n - (cx, cy)) * FORCE_MAX * poids
+static double borne_regle(const Somme& s, double cx, double cy, float poids) {
+
+    double plafond = 2.0 * FORCE_MAX * poids;
+    if (s.n == 0) return 0.0;
+
+    double mx = s.x / s.n - cx, my = s.y / s.n - cy;
+    double norme = std::hypot(mx, my);
+
+    // Sommes, puis division et soustraction arrondies une fois chacune
+    double e = ((s.n - 1) * U * std::hypot(s.abs_x, s.abs_y) + U * std::hypot(s.x, s.y)) / s.n
+             + U * (std::hypot(s.x / s.n, s.y / s.n) + std::hypot(cx, cy));
+
+    // normalize rend zéro sous 1e-5 : près du seuil, tout écart est possible
+    if (norme - e <= 1e-5) return plafond;
+
+    return std::min(plafond, FORCE_MAX * poids * (4.0 * e / (norme - e) + 6.0 * U));
+
+}
+
+static double borne_simd(float x, float y, float vx, float vy, const Voisins& voisins) {
+
+    Somme separation, alignement, cohesion;
+
+    // Mêmes tests de rayon, sur les mêmes flottants, que les noyaux
+    for (size_t k = 0; k < voisins.size(); k ++) {
+
+        float dx = ecart_tore(x - voisins.pos_x[k], WINDOW_WIDTH);
+        float dy = ecart_tore(y - voisins.pos_y[k], WINDOW_HEIGHT);
+        float distance_2 = dx * dx + dy * dy;
+
+        if (distance_2 <= 0) continue;
+
+        if (distance_2 <= float(RAYON_SEPARATION * RAYON_SEPARATION)) {
+
+            float distance = std::sqrt(distance_2);
+            separation.ajouter(dx / distance, dy / distance);
+
+        }
+
+        if (distance_2 <= float(RAYON_ALIGNEMENT * RAYON_ALIGNEMENT)) alignement.ajouter(voisins.vel_x[k], voisins.vel_y[k]);
+        if (distance_2 <= float(RAYON_COHESION * RAYON_COHESION)) cohesion.ajouter(-dx, -dy);
+
+    }
+
+    // Plus les deux additions finales des trois forces
+    return borne_regle(separation, 0.0, 0.0, POIDS_SEPARATION) + borne_regle(alignement, vx, vy, POIDS_ALIGNEMENT)
+         + borne_regle(cohesion, 0.0, 0.0, POIDS_COHESION) + 4.0 * U * FORCE_MAX * (POIDS_SEPARATION + POIDS_ALIGNEMENT + POIDS_COHESION);
+
+}
+
+struct Verification {
+
+    double ecart = 0.0, ratio = 0.0;
+    size_t nb = 0, max_voisins = 0;
+
+    void comparer(Kernel noyau, float x, float y, float vx, float vy, const Voisins& voisins) {
+
+        sf::Vector2f a = noyau(x, y, vx, vy, voisins);
+        sf::Vector2f b = steer_scalar(x, y, vx, vy, voisins);
+        double e = std::max(std::fabs(a.x - b.x), std::fabs(a.y - b.y));
+
+        ecart = std::max(ecart, e);
+        ratio = std::max(ratio, e / borne_simd(x, y, vx, vy, voisins));
+        nb += 1;
+        max_voisins = std::max(max_voisins, voisins.size());
+
+    }
+
+    bool ok() const {
+
+        return ratio <= 1.0;
+
+    }
+
+};
+
+// Listes de Verlet d'un état, telles que FlockBase les construit : boids
+// de la grille à moins de RAYON_VERLET sur le tore
+template <class F>
+static void listes_verlet(const FlockState& etat, F f) {
+
+    SpatialHash grille(RAYON_VERLET);
+    grille.build(etat.pos_x, etat.pos_y);
+
+    std::vector<int> indices;
+    Voisins liste;
+
+    for (size_t i = 0; i < etat.size(); i ++) {
+
+        indices.clear();
+        grille.voisins(etat.pos_x[i], etat.pos_y[i], indices);
+
+        liste.clear();
+
+        for (int j : indices) {
+
+            float dx = ecart_tore(etat.pos_x[i] - etat.pos_x[j], WINDOW_WIDTH);
+            float dy = ecart_tore(etat.pos_y[i] - etat.pos_y[j], WINDOW_HEIGHT);
+
+            if (dx * dx + dy * dy <= float(RAYON_VERLET * RAYON_VERLET)) {
+
+                liste.push_back(etat.pos_x[j], etat.pos_y[j], etat.vel_x[j], etat.vel_y[j]);
+
+            }
+
+        }
+
+        f(i, liste);
+
+    }
+
+}
+
+// Noyau choisi à l'exécution face au scalaire, sur les listes d'un état
+static Verification verifier_simd(const FlockState& etat) {
+
+    Verification v;
+
+    listes_verlet(etat, [&](size_t i, const Voisins& liste) {
+        v.comparer(steer, etat.pos_x[i], etat.pos_y[i], etat.vel_x[i], etat.vel_y[i], liste);
+    });
+
+    return v;
+
+}
+
+// Taille minimale couverte par les voisinages tirés, quelle que soit la
+// distribution observée
+constexpr size_t TAILLE_MAX_SIMD = 1024;
+
+// Chaque noyau disponible face au scalaire : sur les listes de Verlet d'un
+// vrai pas (nb_boids après nb_steps pas, le temps que des bancs se
+// forment), puis sur des voisinages tirés dont la taille suit ces listes,
+// complétés de 0 à 64 voisins (tous les restes SSE et AVX2) et jusqu'à
+// TAILLE_MAX_SIMD voisins au moins
+static bool bench_simd(size_t nb_boids, size_t nb_steps, unsigned long seed, unsigned nb_threads) {
+
+    DefaultFlock flock(nb_threads);
+    flock.spawn(nb_boids, sf::FloatRect({0.0f, 0.0f}, {WINDOW_WIDTH, WINDOW_HEIGHT}), seed);
+
+    for (size_t k = 0; k < nb_steps; k ++) flock.update();
+
+    const FlockState& etat = flock.get_state();
+    auto noyaux = steering_kernels();
+
+    std::vector<Verification> reels(noyaux.size()), tires(noyaux.size());
+    std::vector<size_t> longueurs;
+
+    listes_verlet(etat, [&](size_t i, const Voisins& liste) {
+
+        longueurs.push_back(liste.size());
+
+        for (size_t k = 0; k < noyaux.size(); k ++) {
+
+            reels[k].comparer(noyaux[k].second, etat.pos_x[i], etat.pos_y[i], etat.vel_x[i], etat.vel_y[i], liste);
+
+        }
+
+    });
+
+    std::vector<size_t> tailles;
+
+    for (size_t n = 0; n <= 64; n ++) tailles.push_back(n);
+    for (size_t n = 128; n <= std::max(TAILLE_MAX_SIMD, reels[0].max_voisins); n *= 2) tailles.insert(tailles.end(), {n - 1, n, n + 3});
+
+    Xoshiro aleatoire(seed);
+
+    for (size_t k = 0; k < longueurs.size() / 4; k ++) tailles.push_back(longueurs[aleatoire.next() % longueurs.size()]);
+
+    Voisins voisins;
+
+    for (size_t n : tailles) {
+
+        float x = aleatoire.uniform(0.0f, WINDOW_WIDTH);
+        float y = aleatoire.uniform(0.0f, WINDOW_HEIGHT);
+        float vx = aleatoire.uniform(-VITESSE_MAX, VITESSE_MAX);
+        float vy = aleatoire.uniform(-VITESSE_MAX, VITESSE_MAX);
+
+        // Voisins répartis jusqu'au-delà du rayon de cohésion, de part et
+        // d'autre des bords du tore
+        voisins.clear();
+
+        for (size_t k = 0; k < n; k ++) {
+
+            voisins.push_back(std::fmod(x + aleatoire.uniform(-1.2f * RAYON_COHESION, 1.2f * RAYON_COHESION) + WINDOW_WIDTH, WINDOW_WIDTH),
+                              std::fmod(y + aleatoire.uniform(-1.2f * RAYON_COHESION, 1.2f * RAYON_COHESION) + WINDOW_HEIGHT, WINDOW_HEIGHT),
+                              aleatoire.uniform(-VITESSE_MAX, VITESSE_MAX),
+                              aleatoire.uniform(-VITESSE_MAX, VITESSE_MAX));
+
+        }
+
+        for (size_t k = 0; k < noyaux.size(); k ++) tires[k].comparer(noyaux[k].second, x, y, vx, vy, voisins);
+
+    }
+
+    bool valide = true;
+
+    std::cout << "kernel,source,neighbourhoods,max_neighbours,max_err,max_err_over_bound,check\n";
+
+    for (size_t k = 0; k < noyaux.size(); k ++) {
+
+        for (auto [source, v] : {std::pair<const char*, const Verification&>{"step", reels[k]}, {"drawn", tires[k]}}) {
+
+            valide = valide && v.ok();
+
+            std::cout << noyaux[k].first << ',' << source << ',' << v.nb << ',' << v.max_voisins << ','
+                      << v.ecart << ',' << v.ratio << ',' << (v.ok() ? "ok" : "FAIL") << '\n';
+
+        }
+
+    }
+
+    return valide;
+
+}
+
+// Écarts quadratiques moyens (position sur le tore, vitesse) entre deux états
+static void ecart_etats(const FlockState& a, const FlockState& b, double& position, double& vitesse) {
+
+    position = 0.0;
+    vitesse = 0.0;
+
+    for (size_t i = 0; i < a.size(); i ++) {
+
+        double dx = std::fabs(a.pos_x[i] - b.pos_x[i]);
+        double dy = std::fabs(a.pos_y[i] - b.pos_y[i]);
+        dx = std::min(dx, WINDOW_WIDTH - dx);
+        dy = std::min(dy, WINDOW_HEIGHT - dy);
+
+        position += dx * dx + dy * dy;
+        vitesse += std::pow(a.vel_x[i] - b.vel_x[i], 2) + std::pow(a.vel_y[i] - b.vel_y[i], 2);
+
+    }
+
+    position = std::sqrt(position / std::max<size_t>(a.size(), 1));
+    vitesse = std::sqrt(vitesse / std::max<size_t>(a.size(), 1));
+
+}
+
+template <class F>
+static double mesurer(size_t nb_steps, std::vector<double>& frames_ms, F step) {
+
+    frames_ms.clear();
+    frames_ms.reserve(nb_steps);
+
+    auto debut = std::chrono::steady_clock::now();
+
+    for (size_t k = 0; k < nb_steps; k ++) {
+
+        auto t0 = std::chrono::steady_clock::now();
+        step();
+        auto t1 = std::chrono::steady_clock::now();
+
+        frames_ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+
+}
+
+// Après un pas depuis un état identique, l'écart ne doit pas dépasser la
+// quantification : un demi-pas de position sur chaque axe, un demi-pas de
+// cap et de norme pour la vitesse. En fin de course il n'est que rapporté,
+// les deux trajectoires divergeant comme tout système chaotique
+const double TOLERANCE_POSITION = std::hypot(0.5 * WINDOW_WIDTH / 65536.0, 0.5 * WINDOW_HEIGHT / 65536.0);
+const double TOLERANCE_VITESSE = std::hypot(VITESSE_MAX * M_PI / 256.0, 0.5 * VITESSE_MAX / 255.0);
+
+// Stockage compact : débit, puis perte de précision face au chemin float,
+// sur un pas depuis un état identique et en fin de course
+static bool bench_compact(size_t nb_boids, size_t nb_steps, unsigned long seed, unsigned nb_threads) {
+
+    DefaultFlock flock(nb_threads);
+    flock.spawn(nb_boids, sf::FloatRect({0.0f, 0.0f}, {WINDOW_WIDTH, WINDOW_HEIGHT}), seed);
+
+    CompactFlock compact(nb_threads);
+    compact.load(flock.get_state());
+
+    FlockState etat_compact;
+    compact.store(etat_compact);
+    flock.set_state(etat_compact);
+
+    flock.update();
+    compact.update();
+    compact.store(etat_compact);
+
+    double position_1, vitesse_1;
+    ecart_etats(flock.get_state(), etat_compact, position_1, vitesse_1);
+
+    std::vector<double> frames_ms;
+    double total_s = mesurer(nb_steps, frames_ms, [&] { compact.update(); });
+
+    for (size_t k = 0; k < nb_steps; k ++) flock.update();
+    compact.store(etat_compact);
+
+    double position_fin, vitesse_fin;
+    ecart_etats(flock.get_state(), etat_compact, position_fin, vitesse_fin);
+
+    bool ok = position_1 <= TOLERANCE_POSITION && vitesse_1 <= TOLERANCE_VITESSE;
+
+    std::cout << "boids,steps,threads,seed,bytes_per_boid,steps_per_s,ns_per_boid_step,p50_ms,p99_ms,"
+              << "pos_rmse_1step,vel_rmse_1step,pos_rmse_final,vel_rmse_final,pos_tolerance,vel_tolerance,check\n";
+    std::cout << nb_boids << ',' << nb_steps << ',' << nb_threads << ',' << seed << ','
+              << compact.bytes_per_boid() << ',' << nb_steps / total_s << ','
+              << (nb_boids && nb_steps ? total_s * 1e9 / (double(nb_boids) * nb_steps) : 0.0) << ','
+              << percentile(frames_ms, 0.50) << ',' << percentile(frames_ms, 0.99) << ','
+              << position_1 << ',' << vitesse_1 << ',' << position_fin << ',' << vitesse_fin << ','
+              << TOLERANCE_POSITION << ',' << TOLERANCE_VITESSE << ',' << (ok ? "ok" : "FAIL") << '\n';
+
+    return ok;
+
+}
+
+// Les bandes refont le calcul d'un seul processus, voisins dans un autre
+// ordre : après un pas, l'écart reste à l'échelle de l'arrondi float sur
+// des positions de l'ordre de la fenêtre (6e-5 px à 1000 px)
+constexpr double TOLERANCE_SHARDS = 1e-4;
+
+// Bandes réparties sur plusieurs processus, comparées au chemin en un seul processus
+static bool bench_shards(size_t nb_boids, size_t nb_steps, unsigned long seed, int nb_shards) {
+
+    // Les processus sont créés avant tout autre thread
+    ShardedFlock shards(nb_shards);
+
+    if (shards.size() == 0) {
+
+        std::cerr << "Impossible de lancer les bandes" << std::endl;
+        return false;
+
+    }
+
+    DefaultFlock flock(1);
+
+    flock.spawn(nb_boids, sf::FloatRect({0.0f, 0.0f}, {WINDOW_WIDTH, WINDOW_HEIGHT}), seed);
+
+    FlockState etat_shards;
+    bool valide = shards.load(flock.get_state());
+
+    flock.update();
+    valide = valide && shards.update() && shards.store(etat_shards);
+
+    double position_1, vitesse_1;
+    ecart_etats(flock.get_state(), etat_shards, position_1, vitesse_1);
+
+    std::vector<double> frames_ms;
+    double total_s = mesurer(nb_steps, frames_ms, [&] { valide = valide && shards.update(); });
+
+    for (size_t k = 0; k < nb_steps; k ++) flock.update();
+    valide = valide && shards.store(etat_shards);
+
+    if (!valide) {
+
+        std::cerr << "Une bande a cessé de répondre" << std::endl;
+        return false;
+
+    }
+
+    double position_fin, vitesse_fin;
+    ecart_etats(flock.get_state(), etat_shards, position_fin, vitesse_fin);
+
+    bool ok = position_1 <= TOLERANCE_SHARDS && vitesse_1 <= TOLERANCE_SHARDS;
+
+    std::cout << "boids,steps,shards,seed,steps_per_s,ns_per_boid_step,p50_ms,p99_ms,"
+              << "pos_rmse_1step,vel_rmse_1step,pos_rmse_final,vel_rmse_final,tolerance,check\n";
+    std::cout << nb_boids << ',' << nb_steps << ',' << shards.size() << ',' << seed << ','
+              << nb_steps / total_s << ','
+              << (nb_boids && nb_steps ? total_s * 1e9 / (double(nb_boids) * nb_steps) : 0.0) << ','
+              << percentile(frames_ms, 0.50) << ',' << percentile(frames_ms, 0.99) << ','
+              << position_1 << ',' << vitesse_1 << ',' << position_fin << ',' << vitesse_fin << ','
+              << TOLERANCE_SHARDS << ',' << (ok ? "ok" : "FAIL") << '\n';
+
+    return ok;
+
+}
+
+int main(int argc, char** argv) {
+
+    size_t nb_boids = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    size_t nb_steps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    unsigned long seed = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 42;
+    unsigned nb_threads = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : std::thread::hardware_concurrency();
+    std::string mode = argc > 5 ? argv[5] : "float";
+
+    if (mode == "simd") {
+
+        return bench_simd(nb_boids, nb_steps, seed, nb_threads) ? 0 : 1;
+
+    }
+
+    if (mode == "compact") {
+
+        return bench_compact(nb_boids, nb_steps, seed, nb_threads) ? 0 : 1;
+
+    }
+
+    if (mode == "shards") {
+
+        return bench_shards(nb_boids, nb_steps, seed, nb_threads) ? 0 : 1;
+
+    }
+
+    DefaultFlock flock(nb_threads);
+
+    flock.spawn(nb_boids, sf::FloatRect({0.0f, 0.0f}, {WINDOW_WIDTH, WINDOW_HEIGHT}), seed);
+
+    std::vector<double> frames_ms;
+    double total_s = mesurer(nb_steps, frames_ms, [&] { flock.update(); });
+    double steps_s = nb_steps / total_s;
+    double ns_boid_step = nb_boids && nb_steps ? total_s * 1e9 / (double(nb_boids) * nb_steps) : 0.0;
+
+    // Même départ sans marge : la grille est interrogée à chaque pas
+    DefaultFlock grille_seule(nb_threads);
+    grille_seule.set_verlet_margin(0);
+    grille_seule.spawn(nb_boids, sf::FloatRect({0.0f, 0.0f}, {WINDOW_WIDTH, WINDOW_HEIGHT}), seed);
+
+    std::vector<double> frames_grille_ms;
+    double total_grille_s = mesurer(nb_steps, frames_grille_ms, [&] { grille_seule.update(); });
+
+    Verification simd = verifier_simd(flock.get_state());
+
+    std::cout << "boids,steps,threads,seed,steering,steps_per_s,ns_per_boid_step,p50_ms,p99_ms,verlet_margin,list_rebuilds,"
+              << "grid_steps_per_s,grid_p50_ms,grid_p99_ms,speedup_vs_grid,simd_max_err,simd_err_over_bound,simd_check\n";
+    std::cout << nb_boids << ',' << nb_steps << ',' << nb_threads << ',' << seed << ','
+              << steering_path() << ',' << steps_s << ',' << ns_boid_step << ','
+              << percentile(frames_ms, 0.50) << ',' << percentile(frames_ms, 0.99) << ','
+              << MARGE_VERLET << ',' << flock.get_nb_reconstructions() << ','
+              << nb_steps / total_grille_s << ',' << percentile(frames_grille_ms, 0.50) << ','
+              << percentile(frames_grille_ms, 0.99) << ',' << (total_s > 0.0 ? total_grille_s / total_s : 0.0) << ','
+              << simd.ecart << ',' << simd.ratio << ',' << (simd.ok() ? "ok" : "FAIL") << '\n';
+
+    return simd.ok() ? 0 : 1;
+
+}
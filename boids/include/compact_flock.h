@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "steering.h"
+#include "thread_pool.h"
+#include "spatial_hash.h"
+
+struct FlockState;
+
+// 6 octets par boid : position en virgule fixe 16 bits relative à la fenêtre,
+// cap et vitesse sur 8 bits ; l'accélération n'est jamais stockée.
+// CompactFlock en garde deux, plus l'ordre de la grille : 16 octets par boid
+struct CompactState {
+
+    std::vector<uint16_t> x, y;
+    std::vector<uint8_t> cap, vitesse;
+
+    size_t size() const;
+
+    void resize(size_t n);
+
+};
+
+class CompactFlock {
+
+    private:
+
+        CompactState avant;
+        CompactState apres;
+
+        // Grille construite sur les coordonnées 16 bits, sans cellule par boid
+        SpatialHash grille;
+
+        ThreadPool threads;
+        std::vector<Voisins> candidats;
+        std::vector<std::vector<int>> proches;
+
+        void update_bloc(size_t debut, size_t fin, unsigned id);
+
+    public:
+
+        CompactFlock(unsigned nb_threads = std::thread::hardware_concurrency());
+
+        void load(const FlockState& etat);
+
+        void store(FlockState& etat) const;
+
+        size_t size() const;
+
+        // Mémoire résidente réelle : deux états, grille et index, par boid
+        double bytes_per_boid() const;
+
+        void update();
+
+};
@@ -1,16 +1,74 @@
 #pragma once
+#include <thread>
+#include <algorithm>
+
 #include "boid.h"
+#include "rules.h"
+#include "steering.h"
+#include "obstacles.h"
+#include "profiler.h"
+#include "thread_pool.h"
+#include "spatial_hash.h"
 #include <SFML/Graphics.hpp>
 
-class Flock {
+struct FlockState {
+
+    std::vector<float> pos_x, pos_y;
+    std::vector<float> vel_x, vel_y;
+    std::vector<float> acc_x, acc_y;
+
+    size_t size() const;
+
+    void resize(size_t n);
+
+    void push_back(const Boid& boid);
+
+    void pop_back();
+
+};
+
+// Toute la mécanique du flock ; le noyau de pilotage est fourni par Flock<Regles...>
+class FlockBase {
 
     private:
 
-        std::vector<Boid> boids;
+        // Lecture dans avant, écriture dans apres, puis échange
+        FlockState avant;
+        FlockState apres;
 
-    public:
+        SpatialHash grille;
+        ThreadPool threads;
+        ObstacleField obstacles;
 
-    Flock();
+        // Tampons de voisinage, un par thread
+        std::vector<std::vector<int>> voisins;
+        std::vector<Voisins> candidats;
+
+        // Listes de Verlet (format CSR) et positions lors de leur construction
+        std::vector<int> liste_debut;
+        std::vector<int> liste_voisins;
+        std::vector<std::vector<int>> listes_blocs;
+        std::vector<float> reference_x, reference_y;
+        std::vector<float> deplacement_max;
+        bool listes_valides;
+        size_t nb_reconstructions;
+
+        Profiler* profiler;
+        int section_listes, section_steering;
+
+        Kernel noyau;
+        int rayon_regles, marge;
+        float rayon_verlet;
+
+        void construire_listes();
+
+        void update_bloc(size_t debut, size_t fin, unsigned id);
+
+    protected:
+
+        FlockBase(unsigned nb_threads, Kernel noyau, int rayon_max);
+
+    public:
 
     void update();
 
@@ -18,6 +76,42 @@ class Flock {
 
     void add_boid(const Boid& boid);
 
-    void render(sf::RenderWindow& window) const;
+    void spawn(size_t count, sf::FloatRect region, uint64_t seed);
+
+    const FlockState& get_state() const;
+
+    void set_state(const FlockState& etat);
+
+    ObstacleField& get_obstacles();
+
+    size_t get_nb_reconstructions() const;
+
+    // Marge des listes, bornée à [0, MARGE_VERLET] pour que la grille reste
+    // valide ; 0 revient à interroger la grille à chaque pas
+    void set_verlet_margin(int marge);
+
+    void set_profiler(Profiler* profiler);
+
+};
+
+
+// Flock<Separation<...>, Alignment<...>, Cohesion<...>> : règles et constantes
+// fixées à la compilation, noyau fusionné et spécialisé par le compilateur
+template <class... Regles>
+class Flock : public FlockBase {
+
+    private:
+
+        static constexpr int rayon_max = std::max({Regles::rayon...});
+
+        static_assert(sizeof...(Regles) > 0, "au moins une regle");
+        static_assert(WINDOW_WIDTH / (rayon_max + MARGE_VERLET) >= 3, "rayon trop grand pour la grille");
+        static_assert(WINDOW_HEIGHT / (rayon_max + MARGE_VERLET) >= 3, "rayon trop grand pour la grille");
+
+    public:
+
+        Flock(unsigned nb_threads = std::thread::hardware_concurrency()) : FlockBase(nb_threads, kernel_for<Regles...>(), rayon_max) {}
+
+};
 
-};
\ No newline at end of file
+using DefaultFlock = Flock<DefaultSeparation, DefaultAlignment, DefaultCohesion>;
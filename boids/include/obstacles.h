@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+// Obstacles statiques précalculés en champ de distance signée (SDF) :
+// un pilier est une capsule dont les deux extrémités sont confondues
+class ObstacleField {
+
+    private:
+
+        struct Capsule {
+
+            sf::Vector2f a, b;
+            float rayon;
+
+        };
+
+        struct Texel {
+
+            float distance;
+            float gradient_x, gradient_y;
+
+        };
+
+        std::vector<Capsule> obstacles;
+
+        int largeur, hauteur;
+        std::vector<Texel> champ;
+
+        float distance_exacte(sf::Vector2f p) const;
+
+    public:
+
+        ObstacleField();
+
+        void add_pillar(sf::Vector2f centre, float rayon);
+
+        void add_wall(sf::Vector2f a, sf::Vector2f b, float epaisseur);
+
+        void clear();
+
+        bool empty() const;
+
+        // Recalcule le champ ; à appeler après chaque ajout
+        void bake();
+
+        // Distance signée et gradient (direction d'éloignement) en un seul accès bilinéaire
+        float sample(float x, float y, sf::Vector2f& gradient) const;
+
+        void draw(sf::RenderWindow& window) const;
+
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <SFML/Graphics.hpp>
+
+class Profiler {
+
+    private:
+
+        struct Section {
+
+            std::string nom;
+            std::vector<float> echantillons;
+            float courant;
+
+        };
+
+        std::vector<Section> sections;
+        size_t curseur, nb_frames;
+
+        FILE* csv;
+        sf::Font police;
+        bool police_chargee;
+        bool visible;
+
+    public:
+
+        Profiler();
+
+        ~Profiler();
+
+        int section(const std::string& nom);
+
+        void add(int id, float ms);
+
+        // Clôt la frame : fenêtre glissante et ligne CSV
+        void end_frame();
+
+        bool open_csv(const std::string& chemin);
+
+        bool is_csv_open() const;
+
+        void close_csv();
+
+        void toggle();
+
+        // Tableau moyenne / p99 / max sur la fenêtre glissante
+        std::string summary() const;
+
+        // Affiche le tableau, suivi éventuellement de celui d'un autre thread
+        void draw(sf::RenderWindow& window, const std::string& autres = "");
+
+};
+
+// Chronomètre une portée ; sans effet si le profiler est nul
+class ScopedTimer {
+
+    private:
+
+        Profiler* profiler;
+        int id;
+        std::chrono::steady_clock::time_point debut;
+
+    public:
+
+        ScopedTimer(Profiler* profiler, int id);
+
+        ~ScopedTimer();
+
+};
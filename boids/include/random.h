@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+// xoshiro256+ : générateur rapide et reproductible, initialisé par splitmix64
+class Xoshiro {
+
+    private:
+
+        uint64_t etat[4];
+
+    public:
+
+        Xoshiro(uint64_t seed);
+
+        uint64_t next();
+
+        // Flottant uniforme dans [a, b)
+        float uniform(float a, float b);
+
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+
+struct FlockState;
+
+class FlockRenderer {
+
+    private:
+
+        // Trois sommets par boid, réutilisés d'une frame à l'autre
+        sf::VertexArray sommets;
+
+        // Mode densité : grille réduite, couleur selon la densité et le cap moyen
+        int largeur, hauteur;
+        std::vector<float> densite, cap_x, cap_y;
+        std::vector<uint8_t> pixels;
+        sf::Texture texture;
+
+        void draw_triangles(sf::RenderWindow& window, const FlockState& etat);
+
+        void draw_density(sf::RenderWindow& window, const FlockState& etat);
+
+    public:
+
+        FlockRenderer();
+
+        void draw(sf::RenderWindow& window, const FlockState& etat);
+
+};
@@ -0,0 +1,149 @@
+#pragma once
+#include <cmath>
+#include <tuple>
+#include <algorithm>
+#include <type_traits>
+
+#include "utils.h"
+#include "steering.h"
+#include <SFML/Graphics.hpp>
+
+// Règles de pilotage paramétrées à la compilation : rayon en pixels,
+// poids par référence sur une constante de utils.h. Chaque règle accumule
+// sans branche, le noyau steer_rules les fusionne en un seul passage.
+
+template <int Rayon, const float& Poids>
+struct Separation {
+
+    static constexpr int rayon = Rayon;
+    static constexpr float rayon_2 = float(Rayon) * Rayon;
+
+    float somme_x = 0, somme_y = 0, nb = 0;
+
+    void accumulate(float dx, float dy, float distance_2, float valide, float, float) {
+
+        float m = valide * (distance_2 <= rayon_2);
+        float inverse = m / std::sqrt(std::max(distance_2, 1e-12f));
+
+        somme_x += dx * inverse;
+        somme_y += dy * inverse;
+        nb += m;
+
+    }
+
+    sf::Vector2f force(float, float) const {
+
+        if (nb == 0) return sf::Vector2f(0.0f, 0.0f);
+        return normalize(sf::Vector2f(somme_x / nb, somme_y / nb)) * (FORCE_MAX * Poids);
+
+    }
+
+};
+
+template <int Rayon, const float& Poids>
+struct Alignment {
+
+    static constexpr int rayon = Rayon;
+    static constexpr float rayon_2 = float(Rayon) * Rayon;
+
+    float somme_x = 0, somme_y = 0, nb = 0;
+
+    void accumulate(float, float, float distance_2, float valide, float vx, float vy) {
+
+        float m = valide * (distance_2 <= rayon_2);
+
+        somme_x += vx * m;
+        somme_y += vy * m;
+        nb += m;
+
+    }
+
+    sf::Vector2f force(float vx, float vy) const {
+
+        if (nb == 0) return sf::Vector2f(0.0f, 0.0f);
+        return normalize(sf::Vector2f(somme_x / nb - vx, somme_y / nb - vy)) * (FORCE_MAX * Poids);
+
+    }
+
+};
+
+template <int Rayon, const float& Poids>
+struct Cohesion {
+
+    static constexpr int rayon = Rayon;
+    static constexpr float rayon_2 = float(Rayon) * Rayon;
+
+    float somme_x = 0, somme_y = 0, nb = 0;
+
+    void accumulate(float dx, float dy, float distance_2, float valide, float, float) {
+
+        float m = valide * (distance_2 <= rayon_2);
+
+        somme_x -= dx * m;
+        somme_y -= dy * m;
+        nb += m;
+
+    }
+
+    sf::Vector2f force(float, float) const {
+
+        if (nb == 0) return sf::Vector2f(0.0f, 0.0f);
+        return normalize(sf::Vector2f(somme_x / nb, somme_y / nb)) * (FORCE_MAX * Poids);
+
+    }
+
+};
+
+using DefaultSeparation = Separation<RAYON_SEPARATION, POIDS_SEPARATION>;
+using DefaultAlignment = Alignment<RAYON_ALIGNEMENT, POIDS_ALIGNEMENT>;
+using DefaultCohesion = Cohesion<RAYON_COHESION, POIDS_COHESION>;
+
+template <class... Regles>
+sf::Vector2f steer_rules(float x, float y, float vx, float vy, const Voisins& voisins) {
+
+    std::tuple<Regles...> regles;
+
+    for (size_t k = 0; k < voisins.size(); k ++) {
+
+        float dx = ecart_tore(x - voisins.pos_x[k], WINDOW_WIDTH);
+        float dy = ecart_tore(y - voisins.pos_y[k], WINDOW_HEIGHT);
+        float distance_2 = dx * dx + dy * dy;
+        float valide = distance_2 > 0;
+
+        std::apply([&](auto&... regle) {
+
+            (regle.accumulate(dx, dy, distance_2, valide, voisins.vel_x[k], voisins.vel_y[k]), ...);
+
+        }, regles);
+
+    }
+
+    sf::Vector2f acceleration(0.0f, 0.0f);
+
+    std::apply([&](const auto&... regle) {
+
+        ((acceleration += regle.force(vx, vy)), ...);
+
+    }, regles);
+
+    return acceleration;
+
+}
+
+// Le jeu de règles par défaut garde le noyau SIMD choisi à l'exécution
+template <class... Regles>
+constexpr Kernel kernel_for() {
+
+    if constexpr (std::is_same_v<std::tuple<Regles...>, std::tuple<DefaultSeparation, DefaultAlignment, DefaultCohesion>>) {
+
+        return &steer;
+
+    }
+
+    else {
+
+        return &steer_rules<Regles...>;
+
+    }
+
+}
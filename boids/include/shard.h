@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <sys/types.h>
+
+struct FlockState;
+
+// Monde réparti sur plusieurs processus, chacun propriétaire d'une bande
+// horizontale de la fenêtre. Les bandes voisines, première et dernière
+// comprises puisque le monde est un tore, échangent à chaque pas
+// les boids à moins de RAYON_COHESION de leur bord (halo) et se transmettent
+// ceux qui franchissent une frontière. Transport : sockets Unix locales.
+// À construire avant de lancer d'autres threads (les bandes sont des fork).
+// Si une socket ou un fork échoue, rien n'est lancé et size() vaut 0.
+class ShardedFlock {
+
+    private:
+
+        int nb_shards;
+        std::vector<pid_t> processus;
+        std::vector<int> controle;
+
+        // Ferme les canaux de contrôle, puis attend les bandes qui en sortent
+        void arreter();
+
+        // Arrête tout après une erreur d'échange ; renvoie toujours faux
+        bool echec();
+
+    public:
+
+        ShardedFlock(int nb_shards);
+
+        ~ShardedFlock();
+
+        int size() const;
+
+        // load, update et store : faux si une bande a disparu ou qu'un échange
+        // a échoué ; toutes les bandes sont alors arrêtées et size() vaut 0.
+        // Répartit l'état entre les bandes ; l'indice de chaque boid sert d'identifiant
+        bool load(const FlockState& etat);
+
+        bool update();
+
+        // Rassemble l'état, boids remis dans l'ordre de load
+        bool store(FlockState& etat);
+
+};
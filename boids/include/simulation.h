@@ -1,20 +1,80 @@
 #pragma once
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+#include <functional>
 #include "boid.h"
 #include "flock.h"
 #include "utils.h"
+#include "profiler.h"
+#include "renderer.h"
+#include "obstacles.h"
+#include "trajectory.h"
+#include "triple_buffer.h"
 #include <SFML/Graphics.hpp>
 
+// Ce que le thread de simulation publie à chaque pas
+struct Snapshot {
+
+    FlockState etat;
+    std::string profil;
+
+};
+
 class Simulation {
 
     private:
 
-        Flock flock;
+        // Propriété du thread de simulation une fois lancé
+        DefaultFlock flock;
+        uint64_t graine;
+
+        TrajectoryWriter enregistrement;
+        TrajectoryReader lecture;
+        FlockState trame;
+        size_t frame_lecture;
+        bool replay;
+
+        Profiler profiler_simulation;
+        int section_commandes, section_update, section_publication;
+
+        // Propriété du thread de rendu
         sf::RenderWindow window;
+        FlockRenderer renderer;
+        ObstacleField obstacles_affichage;
+
+        Profiler profiler;
+        int section_evenements, section_rendu;
+
+        // Échanges entre les deux threads
+        TripleBuffer<Snapshot> instantanes;
+
+        std::mutex verrou_commandes;
+        std::vector<std::function<void()>> commandes;
+
+        std::thread thread_simulation;
+        std::atomic<bool> actif;
+
+        // Transmet une modification au thread de simulation
+        void post(std::function<void()> commande);
+
+        // Signale sur stderr un enregistrement qui n'a pas pu être écrit
+        void fermer_enregistrement();
+
+        void simulate();
+
+        void publish();
 
     public:
 
         Simulation();
 
+        ~Simulation();
+
+        bool load_replay(const std::string& chemin);
+
         void run();
 
         void update();
@@ -23,4 +83,4 @@ class Simulation {
 
         void handle_events();
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class SpatialHash {
+
+    private:
+
+        int nb_colonnes, nb_lignes;
+        float largeur_cellule, hauteur_cellule;
+
+        std::vector<int> cellule_debut;
+        std::vector<int> cellule_boid;
+        std::vector<int> indices;
+
+        int cellule_x(float x) const;
+
+        int cellule_y(float y) const;
+
+        // Coordonnées 16 bits relatives à la fenêtre : la cellule sans division
+        int cellule_x(uint16_t x) const;
+
+        int cellule_y(uint16_t y) const;
+
+    public:
+
+        SpatialHash(int rayon);
+
+        void build(const std::vector<float>& pos_x, const std::vector<float>& pos_y);
+
+        // Sans cellule_boid : la cellule est recalculée au second passage,
+        // seuls 4 octets par boid (indices) restent alloués
+        void build(const std::vector<uint16_t>& x, const std::vector<uint16_t>& y);
+
+        void voisins(float x, float y, std::vector<int>& resultat) const;
+
+        void voisins(uint16_t x, uint16_t y, std::vector<int>& resultat) const;
+
+        size_t memory() const;
+
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <SFML/Graphics.hpp>
+
+class ObstacleField;
+
+struct Voisins {
+
+    std::vector<float> pos_x, pos_y;
+    std::vector<float> vel_x, vel_y;
+
+    size_t size() const;
+
+    void clear();
+
+    void push_back(float x, float y, float vx, float vy);
+
+};
+
+float length(sf::Vector2f v);
+
+sf::Vector2f normalize(sf::Vector2f vecteur);
+
+// Écart le plus court sur le tore de période taille
+float ecart_tore(float ecart, float taille);
+
+using Kernel = sf::Vector2f (*)(float x, float y, float vx, float vy, const Voisins& voisins);
+
+// Version SIMD choisie à l'exécution (AVX2, SSE) ou scalaire à défaut
+sf::Vector2f steer(float x, float y, float vx, float vy, const Voisins& voisins);
+
+// Version de référence, sans SIMD
+sf::Vector2f steer_scalar(float x, float y, float vx, float vy, const Voisins& voisins);
+
+const char* steering_path();
+
+// Noyaux exécutables sur ce processeur, le scalaire en premier
+std::vector<std::pair<const char*, Kernel>> steering_kernels();
+
+// Quatrième force : éloignement le long du gradient du champ de distance
+sf::Vector2f avoidance(float x, float y, const ObstacleField& obstacles);
+
+void integrate(float& x, float& y, float& vx, float& vy, float ax, float ay);
@@ -0,0 +1,111 @@
+#pragma once
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <condition_variable>
+
+struct FlockState;
+
+// Fichier : entête, puis une trame par pas (nb boids + pos_x, pos_y, vel_x,
+// vel_y en float ou quantifiés sur 16 bits), puis l'index des trames et le pied
+struct TrajectoryHeader {
+
+    char magic[8];
+    uint32_t version;
+    uint32_t quantifie;
+
+    int32_t window_width, window_height;
+    float vitesse_init, vitesse_max, vitesse_min, force_max;
+    int32_t rayon_separation, rayon_alignement, rayon_cohesion;
+    float poids_separation, poids_cohesion, poids_alignement;
+
+};
+
+struct TrajectoryFooter {
+
+    uint64_t nb_frames;
+    uint64_t offset_index;
+    char magic[8];
+
+};
+
+class TrajectoryWriter {
+
+    private:
+
+        FILE* fichier;
+        bool quantifie;
+        uint64_t offset;
+        std::vector<uint64_t> index;
+
+        // Trames brutes en attente d'écriture, et tampons libres à réutiliser
+        std::deque<std::vector<float>> file;
+        std::vector<std::vector<float>> libres;
+
+        std::mutex mutex;
+        std::condition_variable trame_prete;
+        std::condition_variable place_libre;
+        std::thread ecrivain;
+        bool arret;
+
+        // Une écriture incomplète (disque plein...) ; rapportée par close
+        bool erreur;
+
+        void boucle();
+
+        bool ecrire(const std::vector<float>& trame);
+
+    public:
+
+        TrajectoryWriter();
+
+        ~TrajectoryWriter();
+
+        bool open(const std::string& chemin, bool quantifie);
+
+        bool is_open() const;
+
+        // Copie l'état et rend la main ; l'encodage se fait sur le thread d'écriture
+        void push(const FlockState& etat);
+
+        // Faux si une écriture a échoué : le fichier est alors inutilisable
+        bool close();
+
+};
+
+class TrajectoryReader {
+
+    private:
+
+        const uint8_t* donnees;
+        size_t taille;
+
+        const TrajectoryHeader* entete;
+        const uint64_t* index;
+        size_t nb_frames;
+
+        // Les trames occupent [sizeof(TrajectoryHeader), fin_trames)
+        uint64_t fin_trames;
+
+    public:
+
+        TrajectoryReader();
+
+        ~TrajectoryReader();
+
+        bool open(const std::string& chemin);
+
+        void close();
+
+        size_t frame_count() const;
+
+        const TrajectoryHeader& header() const;
+
+        // Décode la trame k seule, sans lire les précédentes
+        bool frame(size_t k, FlockState& etat) const;
+
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+
+// Triple tampon sans verrou, un écrivain et un lecteur : l'écrivain publie
+// son tampon en l'échangeant avec celui du milieu, le lecteur récupère le
+// milieu s'il est nouveau. Aucun des deux n'attend jamais l'autre.
+template <class T>
+class TripleBuffer {
+
+    private:
+
+        static constexpr int INDEX = 3;
+        static constexpr int NOUVEAU = 4;
+
+        T tampons[3];
+        std::atomic<int> milieu;
+        int ecriture, lecture;
+
+    public:
+
+        TripleBuffer() : milieu(1), ecriture(0), lecture(2) {}
+
+        // Côté écrivain
+        T& write_buffer() {
+
+            return tampons[ecriture];
+
+        }
+
+        void publish() {
+
+            ecriture = milieu.exchange(ecriture | NOUVEAU, std::memory_order_acq_rel) & INDEX;
+
+        }
+
+        // Côté lecteur : vrai si un nouveau tampon a été récupéré
+        bool update() {
+
+            if (!(milieu.load(std::memory_order_relaxed) & NOUVEAU)) return false;
+
+            lecture = milieu.exchange(lecture, std::memory_order_acq_rel) & INDEX;
+            return true;
+
+        }
+
+        const T& read_buffer() const {
+
+            return tampons[lecture];
+
+        }
+
+};
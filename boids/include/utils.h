@@ -1,24 +1,50 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <SFML/Graphics.hpp>
+
 // Fenêtre
 constexpr int WINDOW_WIDTH = 1300;
 constexpr int WINDOW_HEIGHT = 950;
 constexpr unsigned int FRAMERATE_LIMIT = 60;
 
+// Enregistrement
+constexpr const char* FICHIER_TRAJECTOIRE = "trajectoire.bin";
+constexpr bool TRAJECTOIRE_QUANTIFIEE = true;
+
+// Profilage
+constexpr const char* FICHIER_PROFIL = "profil.csv";
+constexpr const char* FICHIER_PROFIL_SIMULATION = "profil_simulation.csv";
+constexpr int FENETRE_PROFIL = 120;
+
 // Boids
 constexpr float VITESSE_INIT = 5.0;
 constexpr float VITESSE_MAX = 8.0;
 constexpr float VITESSE_MIN = 3.0;
 constexpr float FORCE_MAX = 0.2;
+constexpr int NB_BOIDS_SPAWN = 1000;
 
 constexpr int RAYON_SEPARATION = 40;
 constexpr int RAYON_ALIGNEMENT = 50;
 constexpr int RAYON_COHESION = 70;
 
-constexpr float POIDS_SEPARATION = 2.0;
-constexpr float POIDS_COHESION = 0.7;
-constexpr float POIDS_ALIGNEMENT = 1.2;
+// Listes de Verlet : rayon des listes = RAYON_COHESION + MARGE_VERLET.
+// Reconstruites dès qu'un boid a bougé de plus de la demi-marge : sous
+// 2 * VITESSE_MAX elles le seraient à chaque pas, au-delà chaque pas
+// parcourt des listes plus longues (boids_bench compare à la grille seule)
+constexpr int MARGE_VERLET = 2 * static_cast<int>(VITESSE_MAX);
+constexpr int RAYON_VERLET = RAYON_COHESION + MARGE_VERLET;
+
+// inline : les poids servent de paramètres de template (rules.h)
+inline constexpr float POIDS_SEPARATION = 2.0;
+inline constexpr float POIDS_COHESION = 0.7;
+inline constexpr float POIDS_ALIGNEMENT = 1.2;
+
+// Obstacles
+constexpr int TAILLE_TEXEL_SDF = 5;
+constexpr float RAYON_OBSTACLE = 40;
+constexpr float POIDS_OBSTACLE = 3.0;
+constexpr float RAYON_PILIER = 30;
 
 constexpr int WIDTH_BOIDS = 15;
 constexpr int HEIGHT_BOIDS = 15;
@@ -26,4 +52,9 @@ const sf::Vector2f TIP_BOIDS(HEIGHT_BOIDS / 2, 0);
 const sf::Vector2f BASE_BOIDS_1(-HEIGHT_BOIDS / 2, -WIDTH_BOIDS / 2);
 const sf::Vector2f BASE_BOIDS_2(-HEIGHT_BOIDS / 2, WIDTH_BOIDS / 2);
 
+// Rendu par champ de densité au-delà de SEUIL_DENSITE boids
+constexpr size_t SEUIL_DENSITE = 100000;
+constexpr int REDUCTION_DENSITE = 4;
+constexpr float DENSITE_SATURATION = 64.0f;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include <cmath>
+#include <algorithm>
+
+#include "flock.h"
+#include "utils.h"
+#include "steering.h"
+#include "compact_flock.h"
+
+static uint16_t encoder_position(float valeur, float taille) {
+
+    // 65536 pas sur la fenêtre : taille et 0 se confondent, comme au wraparound
+    return static_cast<uint16_t>(static_cast<long>(std::lround(valeur / taille * 65536.0f)) & 0xFFFF);
+
+}
+
+static float decoder_position(uint16_t valeur, float taille) {
+
+    return valeur * (taille / 65536.0f);
+
+}
+
+static void encoder_vitesse(float vx, float vy, uint8_t& cap, uint8_t& vitesse) {
+
+    float angle = std::atan2(vy, vx);
+    float norme = std::min(std::sqrt(vx * vx + vy * vy), VITESSE_MAX);
+
+    cap = static_cast<uint8_t>(static_cast<long>(std::lround(angle / (2 * M_PI) * 256.0f)) & 0xFF);
+    vitesse = static_cast<uint8_t>(std::lround(norme / VITESSE_MAX * 255.0f));
+
+}
+
+static void decoder_vitesse(uint8_t cap, uint8_t vitesse, float& vx, float& vy) {
+
+    float angle = cap * (2 * M_PI / 256.0f);
+    float norme = vitesse * (VITESSE_MAX / 255.0f);
+
+    vx = std::cos(angle) * norme;
+    vy = std::sin(angle) * norme;
+
+}
+
+size_t CompactState::size() const {
+
+    return x.size();
+
+}
+
+void CompactState::resize(size_t n) {
+
+    x.resize(n);
+    y.resize(n);
+    cap.resize(n);
+    vitesse.resize(n);
+
+}
+
+CompactFlock::CompactFlock(unsigned nb_threads) : grille(RAYON_COHESION), threads(nb_threads) {
+
+    candidats.resize(threads.size());
+    proches.resize(threads.size());
+
+}
+
+void CompactFlock::load(const FlockState& etat) {
+
+    avant.resize(etat.size());
+
+    for (size_t i = 0; i < etat.size(); i ++) {
+
+        avant.x[i] = encoder_position(etat.pos_x[i], WINDOW_WIDTH);
+        avant.y[i] = encoder_position(etat.pos_y[i], WINDOW_HEIGHT);
+        encoder_vitesse(etat.vel_x[i], etat.vel_y[i], avant.cap[i], avant.vitesse[i]);
+
+    }
+
+}
+
+void CompactFlock::store(FlockState& etat) const {
+
+    etat.resize(avant.size());
+
+    for (size_t i = 0; i < avant.size(); i ++) {
+
+        etat.pos_x[i] = decoder_position(avant.x[i], WINDOW_WIDTH);
+        etat.pos_y[i] = decoder_position(avant.y[i], WINDOW_HEIGHT);
+        decoder_vitesse(avant.cap[i], avant.vitesse[i], etat.vel_x[i], etat.vel_y[i]);
+        etat.acc_x[i] = 0.0f;
+        etat.acc_y[i] = 0.0f;
+
+    }
+
+}
+
+size_t CompactFlock::size() const {
+
+    return avant.size();
+
+}
+
+double CompactFlock::bytes_per_boid() const {
+
+    auto octets = [](const CompactState& etat) {
+        return etat.x.capacity() * sizeof(uint16_t) + etat.y.capacity() * sizeof(uint16_t)
+            + etat.cap.capacity() + etat.vitesse.capacity();
+    };
+
+    size_t total = octets(avant) + octets(apres) + grille.memory();
+    return avant.size() ? static_cast<double>(total) / avant.size() : 0.0;
+
+}
+
+void CompactFlock::update_bloc(size_t debut, size_t fin, unsigned id) {
+
+    Voisins& voisins = candidats[id];
+    std::vector<int>& indices = proches[id];
+
+    for (size_t i = debut; i < fin; i ++) {
+
+        indices.clear();
+        grille.voisins(avant.x[i], avant.y[i], indices);
+
+        voisins.clear();
+
+        for (int j : indices) {
+
+            float vx, vy;
+            decoder_vitesse(avant.cap[j], avant.vitesse[j], vx, vy);
+            voisins.push_back(decoder_position(avant.x[j], WINDOW_WIDTH), decoder_position(avant.y[j], WINDOW_HEIGHT), vx, vy);
+
+        }
+
+        float x = decoder_position(avant.x[i], WINDOW_WIDTH);
+        float y = decoder_position(avant.y[i], WINDOW_HEIGHT);
+        float vx, vy;
+        decoder_vitesse(avant.cap[i], avant.vitesse[i], vx, vy);
+
+        // L'accélération n'existe que le temps de ce calcul
+        sf::Vector2f acceleration = steer(x, y, vx, vy, voisins);
+        integrate(x, y, vx, vy, acceleration.x, acceleration.y);
+
+        apres.x[i] = encoder_position(x, WINDOW_WIDTH);
+        apres.y[i] = encoder_position(y, WINDOW_HEIGHT);
+        encoder_vitesse(vx, vy, apres.cap[i], apres.vitesse[i]);
+
+    }
+
+}
+
+void CompactFlock::update() {
+
+    grille.build(avant.x, avant.y);
+    apres.resize(avant.size());
+
+    threads.parallel_for(avant.size(), 2048, [this](size_t debut, size_t fin, unsigned id) {
+
+        update_bloc(debut, fin, id);
+
+    });
+
+    std::swap(avant, apres);
+
+}
@@ -1,40 +1,283 @@
+    #include <cmath>
+    #include <algorithm>
+
     #include "boid.h"
     #include "flock.h"
+    #include "utils.h"
+    #include "random.h"
+    #include "steering.h"
     #include <SFML/Graphics.hpp>
 
-    Flock::Flock() {}
+    size_t FlockState::size() const {
+
+        return pos_x.size();
+
+    }
+
+    void FlockState::resize(size_t n) {
+
+        pos_x.resize(n);
+        pos_y.resize(n);
+        vel_x.resize(n);
+        vel_y.resize(n);
+        acc_x.resize(n);
+        acc_y.resize(n);
+
+    }
+
+    void FlockState::push_back(const Boid& boid) {
+
+        pos_x.push_back(boid.get_position().x);
+        pos_y.push_back(boid.get_position().y);
+        vel_x.push_back(boid.get_vitesse().x);
+        vel_y.push_back(boid.get_vitesse().y);
+        acc_x.push_back(0.0f);
+        acc_y.push_back(0.0f);
+
+    }
+
+    void FlockState::pop_back() {
+
+        pos_x.pop_back();
+        pos_y.pop_back();
+        vel_x.pop_back();
+        vel_y.pop_back();
+        acc_x.pop_back();
+        acc_y.pop_back();
+
+    }
+
+    FlockBase::FlockBase(unsigned nb_threads, Kernel noyau, int rayon_max) : grille(rayon_max + MARGE_VERLET), threads(nb_threads), listes_valides(false), nb_reconstructions(0), profiler(nullptr), noyau(noyau), rayon_regles(rayon_max), marge(MARGE_VERLET), rayon_verlet(rayon_max + MARGE_VERLET) {
+
+        voisins.resize(threads.size());
+        candidats.resize(threads.size());
+        deplacement_max.resize(threads.size());
+
+    }
+
+    void FlockBase::add_boid(const Boid& boid) {
+
+        avant.push_back(boid);
+        listes_valides = false;
+
+    }
+
+    void FlockBase::spawn(size_t count, sf::FloatRect region, uint64_t seed) {
+
+        Xoshiro generateur(seed);
+        size_t debut = avant.size();
+
+        avant.resize(debut + count);
+
+        for (size_t i = debut; i < debut + count; i ++) {
+
+            float angle = generateur.uniform(0, 2 * M_PI);
+
+            avant.pos_x[i] = generateur.uniform(region.position.x, region.position.x + region.size.x);
+            avant.pos_y[i] = generateur.uniform(region.position.y, region.position.y + region.size.y);
+            avant.vel_x[i] = std::cos(angle) * VITESSE_INIT;
+            avant.vel_y[i] = std::sin(angle) * VITESSE_INIT;
+            avant.acc_x[i] = 0.0f;
+            avant.acc_y[i] = 0.0f;
+
+        }
+
+        listes_valides = false;
+
+    }
+
+    const FlockState& FlockBase::get_state() const {
+
+        return avant;
+
+    }
+
+    void FlockBase::set_state(const FlockState& etat) {
+
+        avant = etat;
+        listes_valides = false;
+
+    }
+
+    ObstacleField& FlockBase::get_obstacles() {
+
+        return obstacles;
+
+    }
+
+    size_t FlockBase::get_nb_reconstructions() const {
+
+        return nb_reconstructions;
+
+    }
+
+    void FlockBase::set_verlet_margin(int marge) {
 
-    void Flock::add_boid(const Boid& boid) {
+        this->marge = std::min(std::max(marge, 0), MARGE_VERLET);
+        rayon_verlet = rayon_regles + this->marge;
+        grille = SpatialHash(rayon_regles + this->marge);
+        listes_valides = false;
 
-        boids.push_back(boid);
+    }
+
+    void FlockBase::remove_boid() {
+
+        avant.pop_back();
+        listes_valides = false;
 
     }
 
-    void Flock::remove_boid() {
+    void FlockBase::set_profiler(Profiler* p) {
+
+        profiler = p;
+        if (!profiler) return;
+
+        section_listes = profiler->section("listes");
+        section_steering = profiler->section("steering");
+
+    }
+
+    void FlockBase::construire_listes() {
+
+        ScopedTimer chrono(profiler, section_listes);
+
+        const float rayon_verlet_2 = rayon_verlet * rayon_verlet;
+        constexpr size_t TAILLE_BLOC = 512;
+        size_t n = avant.size();
+
+        grille.build(avant.pos_x, avant.pos_y);
+        liste_debut.assign(n + 1, 0);
+        listes_blocs.resize((n + TAILLE_BLOC - 1) / TAILLE_BLOC);
+
+        // Chaque bloc remplit sa propre liste, concaténée ensuite dans l'ordre.
+        // La grille rend aussi les boids de l'autre bord du tore ; la liste
+        // les garde à leur distance repliée, celle que mesurent les noyaux
+        threads.parallel_for(n, TAILLE_BLOC, [&](size_t debut, size_t fin, unsigned id) {
+
+            std::vector<int>& liste = listes_blocs[debut / TAILLE_BLOC];
+            liste.clear();
+
+            for (size_t i = debut; i < fin; i ++) {
+
+                voisins[id].clear();
+                grille.voisins(avant.pos_x[i], avant.pos_y[i], voisins[id]);
+
+                for (int j : voisins[id]) {
+
+                    float dx = ecart_tore(avant.pos_x[i] - avant.pos_x[j], WINDOW_WIDTH);
+                    float dy = ecart_tore(avant.pos_y[i] - avant.pos_y[j], WINDOW_HEIGHT);
+                    if (dx * dx + dy * dy <= rayon_verlet_2) liste.push_back(j);
+
+                }
+
+                liste_debut[i + 1] = liste.size();
+
+            }
+
+        });
+
+        size_t total = 0;
+
+        for (size_t debut = 0; debut < n; debut += TAILLE_BLOC) {
+
+            size_t fin = std::min(debut + TAILLE_BLOC, n);
+
+            for (size_t i = debut + 1; i <= fin; i ++) {
+
+                liste_debut[i] += total;
 
-        boids.pop_back();
+            }
+
+            total += listes_blocs[debut / TAILLE_BLOC].size();
+
+        }
+
+        liste_voisins.resize(total);
+
+        threads.parallel_for(listes_blocs.size(), 1, [&](size_t debut, size_t fin, unsigned) {
+
+            for (size_t b = debut; b < fin; b ++) {
+
+                std::copy(listes_blocs[b].begin(), listes_blocs[b].end(), liste_voisins.begin() + liste_debut[b * TAILLE_BLOC]);
+
+            }
+
+        });
+
+        reference_x = avant.pos_x;
+        reference_y = avant.pos_y;
+        listes_valides = true;
+        nb_reconstructions += 1;
 
     }
 
-    void Flock::update() {
+    void FlockBase::update_bloc(size_t debut, size_t fin, unsigned id) {
+
+        Voisins& candidats_bloc = candidats[id];
+        float deplacement_2 = deplacement_max[id];
+
+        for (size_t i = debut; i < fin; i ++) {
+
+            candidats_bloc.clear();
 
-        for (auto& boid : boids) {
+            for (int k = liste_debut[i]; k < liste_debut[i + 1]; k ++) {
 
-            boid.separation(boids);
-            boid.alignement(boids);
-            boid.cohesion(boids);
-            boid.update();
+                int j = liste_voisins[k];
+                candidats_bloc.push_back(avant.pos_x[j], avant.pos_y[j], avant.vel_x[j], avant.vel_y[j]);
+
+            }
+
+            sf::Vector2f acceleration = noyau(avant.pos_x[i], avant.pos_y[i], avant.vel_x[i], avant.vel_y[i], candidats_bloc);
+            if (!obstacles.empty()) acceleration += avoidance(avant.pos_x[i], avant.pos_y[i], obstacles);
+
+            apres.acc_x[i] = avant.acc_x[i] + acceleration.x;
+            apres.acc_y[i] = avant.acc_y[i] + acceleration.y;
+
+            apres.pos_x[i] = avant.pos_x[i];
+            apres.pos_y[i] = avant.pos_y[i];
+            apres.vel_x[i] = avant.vel_x[i];
+            apres.vel_y[i] = avant.vel_y[i];
+
+            integrate(apres.pos_x[i], apres.pos_y[i], apres.vel_x[i], apres.vel_y[i], apres.acc_x[i], apres.acc_y[i]);
+            apres.acc_x[i] = 0.0f;
+            apres.acc_y[i] = 0.0f;
+
+            float dx = ecart_tore(apres.pos_x[i] - reference_x[i], WINDOW_WIDTH);
+            float dy = ecart_tore(apres.pos_y[i] - reference_y[i], WINDOW_HEIGHT);
+            deplacement_2 = std::max(deplacement_2, dx * dx + dy * dy);
 
         }
 
+        deplacement_max[id] = deplacement_2;
+
     }
 
-    void Flock::render(sf::RenderWindow& window) const {
+    void FlockBase::update() {
 
-        for (const auto& boid : boids) {
+        if (!listes_valides) construire_listes();
 
-            boid.draw(window);
+        apres.resize(avant.size());
+        std::fill(deplacement_max.begin(), deplacement_max.end(), 0.0f);
 
+        {
+            ScopedTimer chrono(profiler, section_steering);
+
+            // Chaque boid ne lit que l'état précédent : résultat indépendant
+            // de l'ordre et du nombre de threads
+            threads.parallel_for(avant.size(), 512, [this](size_t debut, size_t fin, unsigned id) {
+
+                update_bloc(debut, fin, id);
+
+            });
         }
 
+        std::swap(avant, apres);
+
+        // Les listes restent exactes tant qu'aucun boid n'a bougé de plus de
+        // la moitié de la marge depuis leur construction
+        float limite = marge / 2.0f;
+        float deplacement_2 = *std::max_element(deplacement_max.begin(), deplacement_max.end());
+
+        if (deplacement_2 > limite * limite) listes_valides = false;
+
     }
\ No newline at end of file
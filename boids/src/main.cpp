@@ -2,9 +2,18 @@
 #include "simulation.h"
 using namespace std;
 
-int main() {
+int main(int argc, char** argv) {
     
     Simulation s = Simulation();
+
+    // ./boids fichier.bin : relit une trajectoire enregistrée (touche R)
+    if (argc > 1 && !s.load_replay(argv[1])) {
+
+        cerr << "Trajectoire illisible : " << argv[1] << endl;
+        return 1;
+
+    }
+
     s.run();
 
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "utils.h"
+#include "steering.h"
+#include "obstacles.h"
+#include <SFML/Graphics.hpp>
+
+ObstacleField::ObstacleField() {
+
+    largeur = WINDOW_WIDTH / TAILLE_TEXEL_SDF + 1;
+    hauteur = WINDOW_HEIGHT / TAILLE_TEXEL_SDF + 1;
+
+}
+
+void ObstacleField::add_pillar(sf::Vector2f centre, float rayon) {
+
+    obstacles.push_back({centre, centre, rayon});
+
+}
+
+void ObstacleField::add_wall(sf::Vector2f a, sf::Vector2f b, float epaisseur) {
+
+    obstacles.push_back({a, b, epaisseur / 2});
+
+}
+
+void ObstacleField::clear() {
+
+    obstacles.clear();
+    champ.clear();
+
+}
+
+bool ObstacleField::empty() const {
+
+    return champ.empty();
+
+}
+
+float ObstacleField::distance_exacte(sf::Vector2f p) const {
+
+    float distance = std::numeric_limits<float>::max();
+
+    for (const auto& capsule : obstacles) {
+
+        sf::Vector2f ab = capsule.b - capsule.a;
+        sf::Vector2f ap = p - capsule.a;
+
+        float longueur_2 = ab.x * ab.x + ab.y * ab.y;
+        float t = longueur_2 > 0 ? std::clamp((ap.x * ab.x + ap.y * ab.y) / longueur_2, 0.0f, 1.0f) : 0.0f;
+
+        distance = std::min(distance, length(ap - ab * t) - capsule.rayon);
+
+    }
+
+    return distance;
+
+}
+
+void ObstacleField::bake() {
+
+    if (obstacles.empty()) {
+
+        champ.clear();
+        return;
+
+    }
+
+    // Coût proportionnel au nombre d'obstacles, payé une seule fois
+    champ.assign(largeur * hauteur, Texel{0.0f, 0.0f, 0.0f});
+
+    for (int ty = 0; ty < hauteur; ty ++) {
+        for (int tx = 0; tx < largeur; tx ++) {
+
+            sf::Vector2f p(tx * TAILLE_TEXEL_SDF, ty * TAILLE_TEXEL_SDF);
+            champ[ty * largeur + tx].distance = distance_exacte(p);
+
+        }
+    }
+
+    // Gradient par différences centrées, normalisé
+    for (int ty = 0; ty < hauteur; ty ++) {
+        for (int tx = 0; tx < largeur; tx ++) {
+
+            int gauche = std::max(tx - 1, 0), droite = std::min(tx + 1, largeur - 1);
+            int haut = std::max(ty - 1, 0), bas = std::min(ty + 1, hauteur - 1);
+
+            sf::Vector2f gradient(
+                champ[ty * largeur + droite].distance - champ[ty * largeur + gauche].distance,
+                champ[bas * largeur + tx].distance - champ[haut * largeur + tx].distance
+            );
+
+            gradient = normalize(gradient);
+            champ[ty * largeur + tx].gradient_x = gradient.x;
+            champ[ty * largeur + tx].gradient_y = gradient.y;
+
+        }
+    }
+
+}
+
+float ObstacleField::sample(float x, float y, sf::Vector2f& gradient) const {
+
+    float u = std::clamp(x / TAILLE_TEXEL_SDF, 0.0f, largeur - 1.001f);
+    float v = std::clamp(y / TAILLE_TEXEL_SDF, 0.0f, hauteur - 1.001f);
+
+    int tx = static_cast<int>(u);
+    int ty = static_cast<int>(v);
+    float fx = u - tx;
+    float fy = v - ty;
+
+    const Texel& t00 = champ[ty * largeur + tx];
+    const Texel& t10 = champ[ty * largeur + tx + 1];
+    const Texel& t01 = champ[(ty + 1) * largeur + tx];
+    const Texel& t11 = champ[(ty + 1) * largeur + tx + 1];
+
+    float w00 = (1 - fx) * (1 - fy), w10 = fx * (1 - fy);
+    float w01 = (1 - fx) * fy, w11 = fx * fy;
+
+    gradient.x = w00 * t00.gradient_x + w10 * t10.gradient_x + w01 * t01.gradient_x + w11 * t11.gradient_x;
+    gradient.y = w00 * t00.gradient_y + w10 * t10.gradient_y + w01 * t01.gradient_y + w11 * t11.gradient_y;
+
+    return w00 * t00.distance + w10 * t10.distance + w01 * t01.distance + w11 * t11.distance;
+
+}
+
+void ObstacleField::draw(sf::RenderWindow& window) const {
+
+    for (const auto& capsule : obstacles) {
+
+        sf::CircleShape extremite(capsule.rayon);
+        extremite.setOrigin(sf::Vector2f(capsule.rayon, capsule.rayon));
+        extremite.setFillColor(sf::Color(90, 90, 90));
+
+        extremite.setPosition(capsule.a);
+        window.draw(extremite);
+
+        if (capsule.a == capsule.b) continue;
+
+        extremite.setPosition(capsule.b);
+        window.draw(extremite);
+
+        sf::Vector2f ab = capsule.b - capsule.a;
+        sf::RectangleShape corps(sf::Vector2f(length(ab), 2 * capsule.rayon));
+        corps.setOrigin(sf::Vector2f(0.0f, capsule.rayon));
+        corps.setPosition(capsule.a);
+        corps.setRotation(sf::radians(std::atan2(ab.y, ab.x)));
+        corps.setFillColor(sf::Color(90, 90, 90));
+        window.draw(corps);
+
+    }
+
+}
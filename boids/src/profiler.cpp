@@ -0,0 +1,175 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <algorithm>
+
+#include "utils.h"
+#include "profiler.h"
+#include <SFML/Graphics.hpp>
+
+// Polices système essayées pour le HUD
+static const char* const POLICES[] = {
+    "/System/Library/Fonts/Menlo.ttc",
+    "/System/Library/Fonts/Supplemental/Courier New.ttf",
+    "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+    "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+};
+
+Profiler::Profiler() : curseur(0), nb_frames(0), csv(nullptr), police_chargee(false), visible(false) {
+
+    for (const char* chemin : POLICES) {
+
+        if (police.openFromFile(chemin)) {
+
+            police_chargee = true;
+            break;
+
+        }
+
+    }
+
+}
+
+Profiler::~Profiler() {
+
+    close_csv();
+
+}
+
+int Profiler::section(const std::string& nom) {
+
+    for (size_t id = 0; id < sections.size(); id ++) {
+
+        if (sections[id].nom == nom) return id;
+
+    }
+
+    sections.push_back({nom, std::vector<float>(FENETRE_PROFIL, 0.0f), 0.0f});
+    return sections.size() - 1;
+
+}
+
+void Profiler::add(int id, float ms) {
+
+    sections[id].courant += ms;
+
+}
+
+void Profiler::end_frame() {
+
+    if (csv) std::fprintf(csv, "%zu", nb_frames);
+
+    for (auto& section : sections) {
+
+        if (csv) std::fprintf(csv, ",%.4f", section.courant);
+
+        section.echantillons[curseur] = section.courant;
+        section.courant = 0.0f;
+
+    }
+
+    if (csv) std::fputc('\n', csv);
+
+    curseur = (curseur + 1) % FENETRE_PROFIL;
+    nb_frames += 1;
+
+}
+
+bool Profiler::open_csv(const std::string& chemin) {
+
+    close_csv();
+
+    csv = std::fopen(chemin.c_str(), "w");
+    if (!csv) return false;
+
+    std::fprintf(csv, "frame");
+
+    for (const auto& section : sections) {
+
+        std::fprintf(csv, ",%s_ms", section.nom.c_str());
+
+    }
+
+    std::fputc('\n', csv);
+    return true;
+
+}
+
+bool Profiler::is_csv_open() const {
+
+    return csv != nullptr;
+
+}
+
+void Profiler::close_csv() {
+
+    if (csv) std::fclose(csv);
+    csv = nullptr;
+
+}
+
+void Profiler::toggle() {
+
+    visible = !visible;
+
+}
+
+std::string Profiler::summary() const {
+
+    size_t nb = std::min<size_t>(nb_frames, FENETRE_PROFIL);
+    if (nb == 0) return "";
+
+    std::string contenu = "section       moy    p99    max (ms)\n";
+    std::vector<float> tri;
+    char ligne[96];
+
+    for (const auto& section : sections) {
+
+        tri.assign(section.echantillons.begin(), section.echantillons.begin() + nb);
+        std::sort(tri.begin(), tri.end());
+
+        float moyenne = 0.0f;
+        for (float ms : tri) moyenne += ms;
+        moyenne /= nb;
+
+        float p99 = tri[static_cast<size_t>(0.99f * (nb - 1))];
+
+        std::snprintf(ligne, sizeof(ligne), "%-12s %6.2f %6.2f %6.2f\n", section.nom.c_str(), moyenne, p99, tri.back());
+        contenu += ligne;
+
+    }
+
+    return contenu;
+
+}
+
+void Profiler::draw(sf::RenderWindow& window, const std::string& autres) {
+
+    if (!visible || !police_chargee) return;
+
+    std::string contenu = summary();
+    if (!autres.empty()) contenu += "\n" + autres;
+    if (contenu.empty()) return;
+
+    sf::Text texte(police, contenu, 14);
+    texte.setFillColor(sf::Color::White);
+    texte.setPosition(sf::Vector2f(10.0f, 10.0f));
+
+    window.draw(texte);
+
+}
+
+ScopedTimer::ScopedTimer(Profiler* profiler, int id) : profiler(profiler), id(id) {
+
+    if (profiler) debut = std::chrono::steady_clock::now();
+
+}
+
+ScopedTimer::~ScopedTimer() {
+
+    if (!profiler) return;
+
+    auto fin = std::chrono::steady_clock::now();
+    profiler->add(id, std::chrono::duration<float, std::milli>(fin - debut).count());
+
+}
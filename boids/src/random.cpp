@@ -0,0 +1,52 @@
+#include <cstdint>
+
+#include "random.h"
+
+static uint64_t splitmix64(uint64_t& x) {
+
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+
+    return (x << k) | (x >> (64 - k));
+
+}
+
+Xoshiro::Xoshiro(uint64_t seed) {
+
+    for (auto& mot : etat) {
+
+        mot = splitmix64(seed);
+
+    }
+
+}
+
+uint64_t Xoshiro::next() {
+
+    uint64_t resultat = etat[0] + etat[3];
+    uint64_t t = etat[1] << 17;
+
+    etat[2] ^= etat[0];
+    etat[3] ^= etat[1];
+    etat[1] ^= etat[2];
+    etat[0] ^= etat[3];
+    etat[2] ^= t;
+    etat[3] = rotl(etat[3], 45);
+
+    return resultat;
+
+}
+
+float Xoshiro::uniform(float a, float b) {
+
+    // Les 24 bits de poids fort donnent un flottant exact dans [0, 1)
+    float u = (next() >> 40) * (1.0f / 16777216.0f);
+    return a + (b - a) * u;
+
+}
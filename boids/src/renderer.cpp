@@ -0,0 +1,124 @@
+#include <cmath>
+#include <algorithm>
+
+#include "flock.h"
+#include "utils.h"
+#include "renderer.h"
+#include "steering.h"
+#include <SFML/Graphics.hpp>
+
+FlockRenderer::FlockRenderer() : sommets(sf::PrimitiveType::Triangles) {
+
+    largeur = (WINDOW_WIDTH + REDUCTION_DENSITE - 1) / REDUCTION_DENSITE;
+    hauteur = (WINDOW_HEIGHT + REDUCTION_DENSITE - 1) / REDUCTION_DENSITE;
+
+}
+
+void FlockRenderer::draw(sf::RenderWindow& window, const FlockState& etat) {
+
+    if (etat.size() > SEUIL_DENSITE) draw_density(window, etat);
+    else draw_triangles(window, etat);
+
+}
+
+void FlockRenderer::draw_triangles(sf::RenderWindow& window, const FlockState& etat) {
+
+    const sf::Vector2f centre = (TIP_BOIDS + BASE_BOIDS_1 + BASE_BOIDS_2) / 3.0f;
+    const sf::Vector2f forme[3] = {BASE_BOIDS_1 - centre, BASE_BOIDS_2 - centre, TIP_BOIDS - centre};
+
+    sommets.resize(etat.size() * 3);
+
+    for (size_t i = 0; i < etat.size(); i ++) {
+
+        sf::Vector2f direction = normalize(sf::Vector2f(etat.vel_x[i], etat.vel_y[i]));
+        if (direction == sf::Vector2f(0.0f, 0.0f)) direction = sf::Vector2f(1.0f, 0.0f);
+
+        // Rotation de angle(vitesse) + 90°, comme l'ancien ConvexShape
+        float c = -direction.y;
+        float s = direction.x;
+
+        for (int k = 0; k < 3; k ++) {
+
+            sf::Vertex& sommet = sommets[i * 3 + k];
+            sommet.position = sf::Vector2f(
+                etat.pos_x[i] + c * forme[k].x - s * forme[k].y,
+                etat.pos_y[i] + s * forme[k].x + c * forme[k].y
+            );
+            sommet.color = sf::Color::Red;
+
+        }
+
+    }
+
+    window.draw(sommets);
+
+}
+
+static sf::Color teinte(float angle, float luminosite) {
+
+    // Teinte HSV à saturation maximale, angle en radians
+    float h = (angle + M_PI) / (2 * M_PI) * 6.0f;
+    float x = 1.0f - std::fabs(std::fmod(h, 2.0f) - 1.0f);
+    float r = 0, g = 0, b = 0;
+
+    switch (static_cast<int>(h) % 6) {
+
+        case 0: r = 1; g = x; break;
+        case 1: r = x; g = 1; break;
+        case 2: g = 1; b = x; break;
+        case 3: g = x; b = 1; break;
+        case 4: r = x; b = 1; break;
+        default: r = 1; b = x; break;
+
+    }
+
+    return sf::Color(r * luminosite * 255, g * luminosite * 255, b * luminosite * 255);
+
+}
+
+void FlockRenderer::draw_density(sf::RenderWindow& window, const FlockState& etat) {
+
+    if (texture.getSize() != sf::Vector2u(largeur, hauteur)) {
+
+        if (!texture.resize(sf::Vector2u(largeur, hauteur))) return;
+
+    }
+
+    densite.assign(largeur * hauteur, 0.0f);
+    cap_x.assign(largeur * hauteur, 0.0f);
+    cap_y.assign(largeur * hauteur, 0.0f);
+    pixels.resize(largeur * hauteur * 4);
+
+    for (size_t i = 0; i < etat.size(); i ++) {
+
+        int cx = std::min(static_cast<int>(etat.pos_x[i]) / REDUCTION_DENSITE, largeur - 1);
+        int cy = std::min(static_cast<int>(etat.pos_y[i]) / REDUCTION_DENSITE, hauteur - 1);
+        int cellule = std::max(cy, 0) * largeur + std::max(cx, 0);
+
+        densite[cellule] += 1.0f;
+        cap_x[cellule] += etat.vel_x[i];
+        cap_y[cellule] += etat.vel_y[i];
+
+    }
+
+    const float echelle = 1.0f / std::log1p(DENSITE_SATURATION);
+
+    for (int cellule = 0; cellule < largeur * hauteur; cellule ++) {
+
+        float luminosite = std::min(1.0f, std::log1p(densite[cellule]) * echelle);
+        sf::Color couleur = teinte(std::atan2(cap_y[cellule], cap_x[cellule]), luminosite);
+
+        pixels[cellule * 4 + 0] = couleur.r;
+        pixels[cellule * 4 + 1] = couleur.g;
+        pixels[cellule * 4 + 2] = couleur.b;
+        pixels[cellule * 4 + 3] = 255;
+
+    }
+
+    texture.update(pixels.data());
+
+    sf::Sprite sprite(texture);
+    sprite.setScale(sf::Vector2f(REDUCTION_DENSITE, REDUCTION_DENSITE));
+    window.draw(sprite);
+
+}
@@ -0,0 +1,477 @@
+#include <cerrno>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+#include "flock.h"
+#include "shard.h"
+#include "utils.h"
+#include "steering.h"
+#include "spatial_hash.h"
+
+struct Paquet {
+
+    uint32_t id;
+    float x, y, vx, vy;
+
+};
+
+enum Commande : uint32_t { CHARGER, PAS, RENDRE, QUITTER };
+
+// MSG_NOSIGNAL : un pair disparu donne EPIPE plutôt que de tuer le processus
+static bool ecrire(int fd, const void* donnees, size_t taille) {
+
+    const char* p = static_cast<const char*>(donnees);
+
+    while (taille > 0) {
+
+        ssize_t n = ::send(fd, p, taille, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        p += n;
+        taille -= n;
+
+    }
+
+    return true;
+
+}
+
+static bool lire(int fd, void* donnees, size_t taille) {
+
+    char* p = static_cast<char*>(donnees);
+
+    while (taille > 0) {
+
+        ssize_t n = ::read(fd, p, taille);
+        if (n <= 0) return false;
+        p += n;
+        taille -= n;
+
+    }
+
+    return true;
+
+}
+
+static bool envoyer(int fd, const std::vector<Paquet>& paquets) {
+
+    uint64_t nb = paquets.size();
+    return ecrire(fd, &nb, sizeof(nb)) && ecrire(fd, paquets.data(), nb * sizeof(Paquet));
+
+}
+
+static bool recevoir(int fd, std::vector<Paquet>& paquets) {
+
+    uint64_t nb = 0;
+    if (!lire(fd, &nb, sizeof(nb))) return false;
+
+    paquets.resize(nb);
+    return lire(fd, paquets.data(), nb * sizeof(Paquet));
+
+}
+
+// Envoi et réception entrelacés par poll, sans bloquer sur l'un ou l'autre :
+// deux bandes qui s'envoient de gros messages en même temps ne peuvent pas
+// se bloquer mutuellement. Faux si un pair a disparu ou si une erreur survient
+static bool echanger(int fd_envoi, const std::vector<Paquet>& envoi, int fd_reception, std::vector<Paquet>& reception) {
+
+    reception.clear();
+
+    // Même format que envoyer / recevoir : nombre de paquets puis paquets
+    uint64_t nb_envoi = envoi.size(), nb_reception = 0;
+    size_t a_envoyer = fd_envoi >= 0 ? sizeof(nb_envoi) + nb_envoi * sizeof(Paquet) : 0;
+    size_t a_recevoir = fd_reception >= 0 ? sizeof(nb_reception) : 0;
+    size_t envoye = 0, recu = 0;
+
+    while (envoye < a_envoyer || recu < a_recevoir) {
+
+        pollfd attente[2];
+        int nb = 0;
+
+        if (envoye < a_envoyer) attente[nb++] = {fd_envoi, POLLOUT, 0};
+        if (recu < a_recevoir) attente[nb++] = {fd_reception, POLLIN, 0};
+
+        if (poll(attente, nb, -1) < 0) {
+
+            if (errno == EINTR) continue;
+            return false;
+
+        }
+
+        for (int k = 0; k < nb; k ++) {
+
+            if (attente[k].revents & (POLLERR | POLLNVAL)) return false;
+            if (!attente[k].revents) continue;
+
+            if (attente[k].events == POLLOUT) {
+
+                const char* p = envoye < sizeof(nb_envoi)
+                    ? reinterpret_cast<const char*>(&nb_envoi) + envoye
+                    : reinterpret_cast<const char*>(envoi.data()) + (envoye - sizeof(nb_envoi));
+                size_t taille = envoye < sizeof(nb_envoi) ? sizeof(nb_envoi) - envoye : a_envoyer - envoye;
+
+                ssize_t n = ::send(fd_envoi, p, taille, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+                if (n <= 0) return false;
+                envoye += n;
+
+            }
+
+            else {
+
+                char* p = recu < sizeof(nb_reception)
+                    ? reinterpret_cast<char*>(&nb_reception) + recu
+                    : reinterpret_cast<char*>(reception.data()) + (recu - sizeof(nb_reception));
+
+                ssize_t n = ::recv(fd_reception, p, a_recevoir - recu, MSG_DONTWAIT);
+
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+                if (n <= 0) return false;
+                recu += n;
+
+                // Entête complet : la taille du message est connue
+                if (recu == sizeof(nb_reception) && a_recevoir == sizeof(nb_reception)) {
+
+                    reception.resize(nb_reception);
+                    a_recevoir += nb_reception * sizeof(Paquet);
+
+                }
+
+            }
+
+        }
+
+    }
+
+    return true;
+
+}
+
+static int bande(float y, int nb_shards) {
+
+    int b = static_cast<int>(y * nb_shards / WINDOW_HEIGHT);
+    return std::min(std::max(b, 0), nb_shards - 1);
+
+}
+
+static bool pas(std::vector<Paquet>& propres, int rang, int nb_shards, int haut, int bas) {
+
+    float y0 = static_cast<float>(rang) * WINDOW_HEIGHT / nb_shards;
+    float y1 = static_cast<float>(rang + 1) * WINDOW_HEIGHT / nb_shards;
+
+    // Halo : anneau comme la migration, les distances étant toriques ; seule,
+    // une bande couvre tout le monde et sa grille voit déjà l'autre bord
+    std::vector<Paquet> halo_vers_haut, halo_vers_bas, halo_haut, halo_bas;
+
+    if (nb_shards > 1) {
+
+        for (const auto& p : propres) {
+
+            if (p.y < y0 + RAYON_COHESION) halo_vers_haut.push_back(p);
+            if (p.y >= y1 - RAYON_COHESION) halo_vers_bas.push_back(p);
+
+        }
+
+        if (!echanger(bas, halo_vers_bas, haut, halo_haut)) return false;
+        if (!echanger(haut, halo_vers_haut, bas, halo_bas)) return false;
+
+    }
+
+    // Boids locaux suivis du halo, en lecture seule pendant le pas
+    std::vector<float> x, y, vx, vy;
+
+    for (const auto* groupe : {&propres, &halo_haut, &halo_bas}) {
+
+        for (const auto& p : *groupe) {
+
+            x.push_back(p.x);
+            y.push_back(p.y);
+            vx.push_back(p.vx);
+            vy.push_back(p.vy);
+
+        }
+
+    }
+
+    SpatialHash grille(RAYON_COHESION);
+    grille.build(x, y);
+
+    std::vector<int> voisins;
+    Voisins candidats;
+    std::vector<Paquet> gardes, vers_haut, vers_bas, depuis_haut, depuis_bas;
+
+    for (size_t i = 0; i < propres.size(); i ++) {
+
+        voisins.clear();
+        grille.voisins(x[i], y[i], voisins);
+
+        candidats.clear();
+
+        for (int j : voisins) {
+
+            candidats.push_back(x[j], y[j], vx[j], vy[j]);
+
+        }
+
+        Paquet p = propres[i];
+        sf::Vector2f acceleration = steer(p.x, p.y, p.vx, p.vy, candidats);
+        integrate(p.x, p.y, p.vx, p.vy, acceleration.x, acceleration.y);
+
+        int b = bande(p.y, nb_shards);
+
+        if (b == rang) gardes.push_back(p);
+        else if (b == (rang + nb_shards - 1) % nb_shards) vers_haut.push_back(p);
+        else vers_bas.push_back(p);
+
+    }
+
+    // Migration : anneau, le wraparound vertical relie la première et la dernière bande
+    if (nb_shards > 1) {
+
+        if (!echanger(haut, vers_haut, bas, depuis_bas)) return false;
+        if (!echanger(bas, vers_bas, haut, depuis_haut)) return false;
+
+    }
+
+    gardes.insert(gardes.end(), depuis_haut.begin(), depuis_haut.end());
+    gardes.insert(gardes.end(), depuis_bas.begin(), depuis_bas.end());
+    propres.swap(gardes);
+
+    return true;
+
+}
+
+static void boucle_shard(int rang, int nb_shards, int controle, int haut, int bas) {
+
+    std::vector<Paquet> propres;
+    uint32_t commande;
+    uint32_t fait = 1;
+
+    // Toute erreur arrête la bande : le parent et les voisines voient la fin de fichier
+    while (lire(controle, &commande, sizeof(commande))) {
+
+        bool valide = false;
+
+        if (commande == CHARGER) valide = recevoir(controle, propres);
+        else if (commande == PAS) valide = pas(propres, rang, nb_shards, haut, bas) && ecrire(controle, &fait, sizeof(fait));
+        else if (commande == RENDRE) valide = envoyer(controle, propres);
+
+        if (!valide) break;
+
+    }
+
+}
+
+ShardedFlock::ShardedFlock(int nb) {
+
+    // Une bande doit être plus haute que le rayon pour que le halo ne
+    // concerne que les bandes adjacentes
+    nb_shards = std::min(std::max(nb, 1), WINDOW_HEIGHT / RAYON_COHESION);
+
+    // Lien k : entre la bande k et la bande k + 1 (modulo), deux extrémités
+    std::vector<int> liens;
+    bool valide = true;
+
+    for (int k = 0; k < nb_shards && valide; k ++) {
+
+        int paire[2];
+        valide = socketpair(AF_UNIX, SOCK_STREAM, 0, paire) == 0;
+
+        if (valide) liens.insert(liens.end(), paire, paire + 2);
+
+    }
+
+    for (int rang = 0; rang < nb_shards && valide; rang ++) {
+
+        int canal[2];
+
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, canal) != 0) {
+
+            valide = false;
+            break;
+
+        }
+
+        pid_t pid = fork();
+
+        if (pid < 0) {
+
+            ::close(canal[0]);
+            ::close(canal[1]);
+            valide = false;
+            break;
+
+        }
+
+        if (pid == 0) {
+
+            int bas = liens[2 * rang];
+            int haut = liens[2 * ((rang + nb_shards - 1) % nb_shards) + 1];
+
+            // Seules ses deux extrémités de lien et son canal restent ouverts :
+            // la mort d'une voisine se voit alors comme une fin de fichier
+            ::close(canal[0]);
+
+            for (int fd : controle) ::close(fd);
+
+            for (int fd : liens) {
+
+                if (fd != bas && fd != haut) ::close(fd);
+
+            }
+
+            boucle_shard(rang, nb_shards, canal[1], haut, bas);
+            _exit(0);
+
+        }
+
+        ::close(canal[1]);
+        processus.push_back(pid);
+        controle.push_back(canal[0]);
+
+    }
+
+    for (int fd : liens) {
+
+        ::close(fd);
+
+    }
+
+    // Anneau incomplet : les bandes déjà lancées s'arrêtent sur la fin du canal
+    if (!valide) {
+
+        arreter();
+        nb_shards = 0;
+
+    }
+
+}
+
+void ShardedFlock::arreter() {
+
+    uint32_t commande = QUITTER;
+
+    for (int fd : controle) {
+
+        ecrire(fd, &commande, sizeof(commande));
+        ::close(fd);
+
+    }
+
+    for (pid_t pid : processus) {
+
+        waitpid(pid, nullptr, 0);
+
+    }
+
+    controle.clear();
+    processus.clear();
+
+}
+
+bool ShardedFlock::echec() {
+
+    arreter();
+    nb_shards = 0;
+    return false;
+
+}
+
+ShardedFlock::~ShardedFlock() {
+
+    arreter();
+
+}
+
+int ShardedFlock::size() const {
+
+    return nb_shards;
+
+}
+
+bool ShardedFlock::load(const FlockState& etat) {
+
+    if (controle.empty()) return false;
+
+    std::vector<std::vector<Paquet>> bandes(nb_shards);
+
+    for (size_t i = 0; i < etat.size(); i ++) {
+
+        Paquet p = {static_cast<uint32_t>(i), etat.pos_x[i], etat.pos_y[i], etat.vel_x[i], etat.vel_y[i]};
+        bandes[bande(p.y, nb_shards)].push_back(p);
+
+    }
+
+    uint32_t commande = CHARGER;
+
+    for (int rang = 0; rang < nb_shards; rang ++) {
+
+        if (!ecrire(controle[rang], &commande, sizeof(commande)) || !envoyer(controle[rang], bandes[rang])) return echec();
+
+    }
+
+    return true;
+
+}
+
+bool ShardedFlock::update() {
+
+    if (controle.empty()) return false;
+
+    uint32_t commande = PAS;
+    uint32_t fait;
+
+    for (int fd : controle) {
+
+        if (!ecrire(fd, &commande, sizeof(commande))) return echec();
+
+    }
+
+    for (int fd : controle) {
+
+        if (!lire(fd, &fait, sizeof(fait))) return echec();
+
+    }
+
+    return true;
+
+}
+
+bool ShardedFlock::store(FlockState& etat) {
+
+    if (controle.empty()) return false;
+
+    uint32_t commande = RENDRE;
+    std::vector<Paquet> tous, bande_courante;
+
+    for (int fd : controle) {
+
+        if (!ecrire(fd, &commande, sizeof(commande)) || !recevoir(fd, bande_courante)) return echec();
+        tous.insert(tous.end(), bande_courante.begin(), bande_courante.end());
+
+    }
+
+    std::sort(tous.begin(), tous.end(), [](const Paquet& a, const Paquet& b) { return a.id < b.id; });
+
+    etat.resize(tous.size());
+
+    for (size_t i = 0; i < tous.size(); i ++) {
+
+        etat.pos_x[i] = tous[i].x;
+        etat.pos_y[i] = tous[i].y;
+        etat.vel_x[i] = tous[i].vx;
+        etat.vel_y[i] = tous[i].vy;
+        etat.acc_x[i] = 0.0f;
+        etat.acc_y[i] = 0.0f;
+
+    }
+
+    return true;
+
+}
\ No newline at end of file
@@ -1,13 +1,48 @@
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <iostream>
+#include <algorithm>
+
 #include "boid.h"
 #include "flock.h"
 #include "utils.h"
 #include "simulation.h"
 #include <SFML/Graphics.hpp>
 
-Simulation::Simulation() : window(sf::VideoMode({WINDOW_WIDTH, WINDOW_HEIGHT}), "Boid Simulation") {
+Simulation::Simulation() : graine(0), frame_lecture(0), replay(false), window(sf::VideoMode({WINDOW_WIDTH, WINDOW_HEIGHT}), "Boid Simulation"), actif(false) {
 
     window.setFramerateLimit(FRAMERATE_LIMIT);
 
+    section_commandes = profiler_simulation.section("commandes");
+    section_update = profiler_simulation.section("update");
+    section_publication = profiler_simulation.section("publication");
+    flock.set_profiler(&profiler_simulation);
+
+    section_evenements = profiler.section("evenements");
+    section_rendu = profiler.section("rendu");
+
+}
+
+Simulation::~Simulation() {
+
+    actif = false;
+    if (thread_simulation.joinable()) thread_simulation.join();
+
+}
+
+void Simulation::post(std::function<void()> commande) {
+
+    std::lock_guard<std::mutex> garde(verrou_commandes);
+    commandes.push_back(std::move(commande));
+
+}
+
+void Simulation::fermer_enregistrement() {
+
+    if (!enregistrement.close()) std::cerr << "Trajectoire incomplète : " << FICHIER_TRAJECTOIRE << std::endl;
+
 }
 
 void Simulation::handle_events() {
@@ -19,45 +54,220 @@ void Simulation::handle_events() {
             window.close();
 
         }
-        
-        if (const auto* mousePress = event->getIf<sf::Event::MouseButtonPressed>()) { 
 
-            Boid new_boid;
+        if (auto keyPressed = event->getIf<sf::Event::KeyPressed>()) {
+
+            if (keyPressed->code == sf::Keyboard::Key::Space && !replay) {
+
+                post([this] { flock.spawn(NB_BOIDS_SPAWN, sf::FloatRect({0.0f, 0.0f}, {WINDOW_WIDTH, WINDOW_HEIGHT}), graine++); });
+
+            }
+
+            if (keyPressed->code == sf::Keyboard::Key::R && !replay) {
+
+                post([this] {
+                    if (enregistrement.is_open()) fermer_enregistrement();
+                    else enregistrement.open(FICHIER_TRAJECTOIRE, TRAJECTOIRE_QUANTIFIEE);
+                });
+
+            }
+
+            if (keyPressed->code == sf::Keyboard::Key::C && !replay) {
+
+                obstacles_affichage.clear();
+                post([this] { flock.get_obstacles().clear(); });
+
+            }
 
-            new_boid.set_position(sf::Vector2f(
-                static_cast<float>(mousePress->position.x), 
-                static_cast<float>(mousePress->position.y)
-            ));
+            if (keyPressed->code == sf::Keyboard::Key::H) {
 
-            flock.add_boid(new_boid);
+                profiler.toggle();
+
+            }
+
+            if (keyPressed->code == sf::Keyboard::Key::P) {
+
+                bool ouvrir = !profiler.is_csv_open();
+
+                if (ouvrir) profiler.open_csv(FICHIER_PROFIL);
+                else profiler.close_csv();
+
+                post([this, ouvrir] {
+                    if (ouvrir) profiler_simulation.open_csv(FICHIER_PROFIL_SIMULATION);
+                    else profiler_simulation.close_csv();
+                });
+
+            }
+
+            if (keyPressed->code == sf::Keyboard::Key::Right && replay) {
+
+                post([this] { frame_lecture = std::min(frame_lecture + FRAMERATE_LIMIT, lecture.frame_count() - 1); });
+
+            }
+
+            if (keyPressed->code == sf::Keyboard::Key::Left && replay) {
+
+                post([this] { frame_lecture -= std::min<size_t>(frame_lecture, FRAMERATE_LIMIT); });
+
+            }
+
+        }
+
+        if (const auto* mousePress = event->getIf<sf::Event::MouseButtonPressed>(); mousePress && !replay) { 
+
+            sf::Vector2f position(mousePress->position);
+
+            if (mousePress->button == sf::Mouse::Button::Right) {
+
+                // Le champ affiché n'a pas besoin d'être cuit
+                obstacles_affichage.add_pillar(position, RAYON_PILIER);
+
+                post([this, position] {
+                    ObstacleField& obstacles = flock.get_obstacles();
+                    obstacles.add_pillar(position, RAYON_PILIER);
+                    obstacles.bake();
+                });
+
+                continue;
+
+            }
+
+            post([this, position] {
+                Boid new_boid;
+                new_boid.set_position(position);
+                flock.add_boid(new_boid);
+            });
 
         }
     }
 }
 
+bool Simulation::load_replay(const std::string& chemin) {
+
+    if (!lecture.open(chemin) || lecture.frame_count() == 0 || !lecture.frame(0, trame)) return false;
+
+    replay = true;
+    frame_lecture = 0;
+
+    return true;
+
+}
+
 void Simulation::update() {
 
+    if (replay) {
+
+        // Une trame corrompue laisse affichée la précédente
+        if (lecture.frame(frame_lecture, trame)) flock.set_state(trame);
+
+        if (frame_lecture + 1 < lecture.frame_count()) frame_lecture += 1;
+
+        return;
+
+    }
+
     flock.update();
 
+    if (enregistrement.is_open()) enregistrement.push(flock.get_state());
+
+}
+
+void Simulation::publish() {
+
+    Snapshot& instantane = instantanes.write_buffer();
+
+    // Les tampons gardent leur capacité, la copie ne réalloue pas en régime
+    instantane.etat = flock.get_state();
+    instantane.profil = profiler_simulation.summary();
+
+    instantanes.publish();
+
+}
+
+void Simulation::simulate() {
+
+    using Horloge = std::chrono::steady_clock;
+
+    const auto pas = std::chrono::duration_cast<Horloge::duration>(std::chrono::duration<double>(1.0 / FRAMERATE_LIMIT));
+    auto echeance = Horloge::now();
+
+    std::vector<std::function<void()>> a_executer;
+
+    while (actif) {
+
+        {
+            ScopedTimer chrono(&profiler_simulation, section_commandes);
+
+            {
+                std::lock_guard<std::mutex> garde(verrou_commandes);
+                a_executer.swap(commandes);
+            }
+
+            for (auto& commande : a_executer) commande();
+            a_executer.clear();
+        }
+
+        {
+            ScopedTimer chrono(&profiler_simulation, section_update);
+            update();
+        }
+
+        {
+            ScopedTimer chrono(&profiler_simulation, section_publication);
+            publish();
+        }
+
+        profiler_simulation.end_frame();
+
+        // Pas fixe ; après un gros retard on repart de maintenant plutôt que
+        // d'enchaîner les pas pour rattraper
+        echeance += pas;
+        auto maintenant = Horloge::now();
+
+        if (maintenant - echeance > 4 * pas) echeance = maintenant;
+        else std::this_thread::sleep_until(echeance);
+
+    }
+
+    if (enregistrement.is_open()) fermer_enregistrement();
+
 }
 
 void Simulation::render() {
 
+    instantanes.update();
+    const Snapshot& instantane = instantanes.read_buffer();
+
     window.clear();
-    flock.render(window);
+    obstacles_affichage.draw(window);
+    renderer.draw(window, instantane.etat);
+    profiler.draw(window, instantane.profil);
     window.display();
 
 }
 
 void Simulation::run() {
 
+    actif = true;
+    thread_simulation = std::thread(&Simulation::simulate, this);
+
     while (window.isOpen()) {
 
-        handle_events();
-        update();
-        render();
+        {
+            ScopedTimer chrono(&profiler, section_evenements);
+            handle_events();
+        }
+
+        {
+            ScopedTimer chrono(&profiler, section_rendu);
+            render();
+        }
+
+        profiler.end_frame();
 
     }
-    
 
-}
\ No newline at end of file
+    actif = false;
+    thread_simulation.join();
+
+}
@@ -0,0 +1,153 @@
+#include <vector>
+#include <cstdint>
+
+#include "spatial_hash.h"
+#include "utils.h"
+
+// Le bloc 3x3 doit contenir 9 cellules distinctes pour le plus grand rayon utilisé
+static_assert(WINDOW_WIDTH / RAYON_VERLET >= 3, "fenetre trop etroite pour la grille");
+static_assert(WINDOW_HEIGHT / RAYON_VERLET >= 3, "fenetre trop basse pour la grille");
+
+SpatialHash::SpatialHash(int rayon) {
+
+    nb_colonnes = WINDOW_WIDTH / rayon;
+    nb_lignes = WINDOW_HEIGHT / rayon;
+
+    largeur_cellule = static_cast<float>(WINDOW_WIDTH) / nb_colonnes;
+    hauteur_cellule = static_cast<float>(WINDOW_HEIGHT) / nb_lignes;
+
+    cellule_debut.assign(nb_colonnes * nb_lignes + 1, 0);
+
+}
+
+int SpatialHash::cellule_x(float x) const {
+
+    int c = static_cast<int>(x / largeur_cellule) % nb_colonnes;
+    return c < 0 ? c + nb_colonnes : c;
+
+}
+
+int SpatialHash::cellule_y(float y) const {
+
+    int l = static_cast<int>(y / hauteur_cellule) % nb_lignes;
+    return l < 0 ? l + nb_lignes : l;
+
+}
+
+int SpatialHash::cellule_x(uint16_t x) const {
+
+    return (x * nb_colonnes) >> 16;
+
+}
+
+int SpatialHash::cellule_y(uint16_t y) const {
+
+    return (y * nb_lignes) >> 16;
+
+}
+
+void SpatialHash::build(const std::vector<float>& pos_x, const std::vector<float>& pos_y) {
+
+    int nb_cellules = nb_colonnes * nb_lignes;
+
+    cellule_debut.assign(nb_cellules + 1, 0);
+    cellule_boid.resize(pos_x.size());
+    indices.resize(pos_x.size());
+
+    for (size_t i = 0; i < pos_x.size(); i ++) {
+
+        int cellule = cellule_y(pos_y[i]) * nb_colonnes + cellule_x(pos_x[i]);
+        cellule_boid[i] = cellule;
+        cellule_debut[cellule + 1] += 1;
+
+    }
+
+    for (int c = 0; c < nb_cellules; c ++) {
+
+        cellule_debut[c + 1] += cellule_debut[c];
+
+    }
+
+    // Tri par comptage : les boids d'une même cellule sont contigus dans indices
+    std::vector<int> curseur(cellule_debut.begin(), cellule_debut.end() - 1);
+
+    for (size_t i = 0; i < pos_x.size(); i ++) {
+
+        indices[curseur[cellule_boid[i]]++] = static_cast<int>(i);
+
+    }
+
+}
+
+void SpatialHash::build(const std::vector<uint16_t>& x, const std::vector<uint16_t>& y) {
+
+    int nb_cellules = nb_colonnes * nb_lignes;
+
+    cellule_debut.assign(nb_cellules + 1, 0);
+    cellule_boid.clear();
+    cellule_boid.shrink_to_fit();
+    indices.resize(x.size());
+
+    for (size_t i = 0; i < x.size(); i ++) {
+
+        cellule_debut[cellule_y(y[i]) * nb_colonnes + cellule_x(x[i]) + 1] += 1;
+
+    }
+
+    for (int c = 0; c < nb_cellules; c ++) {
+
+        cellule_debut[c + 1] += cellule_debut[c];
+
+    }
+
+    std::vector<int> curseur(cellule_debut.begin(), cellule_debut.end() - 1);
+
+    for (size_t i = 0; i < x.size(); i ++) {
+
+        indices[curseur[cellule_y(y[i]) * nb_colonnes + cellule_x(x[i])]++] = static_cast<int>(i);
+
+    }
+
+}
+
+// Boids du bloc 3x3 centré sur la cellule (cx, cy), sur le tore
+static void bloc(int cx, int cy, int nb_colonnes, int nb_lignes, const std::vector<int>& cellule_debut, const std::vector<int>& indices, std::vector<int>& resultat) {
+
+    for (int dy = -1; dy <= 1; dy ++) {
+
+        int l = (cy + dy + nb_lignes) % nb_lignes;
+
+        for (int dx = -1; dx <= 1; dx ++) {
+
+            int c = (cx + dx + nb_colonnes) % nb_colonnes;
+            int cellule = l * nb_colonnes + c;
+
+            for (int k = cellule_debut[cellule]; k < cellule_debut[cellule + 1]; k ++) {
+
+                resultat.push_back(indices[k]);
+
+            }
+
+        }
+
+    }
+
+}
+
+void SpatialHash::voisins(float x, float y, std::vector<int>& resultat) const {
+
+    bloc(cellule_x(x), cellule_y(y), nb_colonnes, nb_lignes, cellule_debut, indices, resultat);
+
+}
+
+void SpatialHash::voisins(uint16_t x, uint16_t y, std::vector<int>& resultat) const {
+
+    bloc(cellule_x(x), cellule_y(y), nb_colonnes, nb_lignes, cellule_debut, indices, resultat);
+
+}
+
+size_t SpatialHash::memory() const {
+
+    return (cellule_debut.capacity() + cellule_boid.capacity() + indices.capacity()) * sizeof(int);
+
+}
\ No newline at end of file
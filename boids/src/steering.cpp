@@ -0,0 +1,386 @@
+#include <cmath>
+#include <algorithm>
+
+#include "utils.h"
+#include "steering.h"
+#include "obstacles.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define STEERING_X86 1
+#include <immintrin.h>
+#else
+#define STEERING_X86 0
+#endif
+
+constexpr float RAYON_SEPARATION_2 = RAYON_SEPARATION * RAYON_SEPARATION;
+constexpr float RAYON_ALIGNEMENT_2 = RAYON_ALIGNEMENT * RAYON_ALIGNEMENT;
+constexpr float RAYON_COHESION_2 = RAYON_COHESION * RAYON_COHESION;
+
+// Le monde est un tore : la grille et les listes rendent les voisins de
+// l'autre bord, les noyaux les voient à leur distance repliée
+constexpr float LARGEUR = WINDOW_WIDTH;
+constexpr float HAUTEUR = WINDOW_HEIGHT;
+
+size_t Voisins::size() const {
+
+    return pos_x.size();
+
+}
+
+void Voisins::clear() {
+
+    pos_x.clear();
+    pos_y.clear();
+    vel_x.clear();
+    vel_y.clear();
+
+}
+
+void Voisins::push_back(float x, float y, float vx, float vy) {
+
+    pos_x.push_back(x);
+    pos_y.push_back(y);
+    vel_x.push_back(vx);
+    vel_y.push_back(vy);
+
+}
+
+float length(sf::Vector2f v) {
+
+    return std::sqrt(v.x * v.x + v.y * v.y);
+
+}
+
+sf::Vector2f normalize(sf::Vector2f vecteur) {
+
+    float l = length(vecteur);
+    if (l <= 0.00001f) return sf::Vector2f(0.0f, 0.0f);
+    return sf::Vector2f(vecteur.x / l, vecteur.y / l);
+
+}
+
+float ecart_tore(float ecart, float taille) {
+
+    if (ecart > taille / 2) return ecart - taille;
+    if (ecart < -taille / 2) return ecart + taille;
+    return ecart;
+
+}
+
+struct Accumulateurs {
+
+    sf::Vector2f separation, alignement, cohesion;
+    float nb_separation, nb_alignement, nb_cohesion;
+
+};
+
+static void accumuler(Accumulateurs& acc, float x, float y, const Voisins& voisins, size_t debut) {
+
+    // Un seul passage : distances au carré comparées aux trois rayons,
+    // la racine n'est calculée que pour la séparation
+    for (size_t k = debut; k < voisins.size(); k ++) {
+
+        float dx = ecart_tore(x - voisins.pos_x[k], LARGEUR);
+        float dy = ecart_tore(y - voisins.pos_y[k], HAUTEUR);
+        float distance_2 = dx * dx + dy * dy;
+
+        if (distance_2 <= 0) continue;
+
+        if (distance_2 <= RAYON_SEPARATION_2) {
+
+            float distance = std::sqrt(distance_2);
+            acc.separation.x += dx / distance;
+            acc.separation.y += dy / distance;
+            acc.nb_separation += 1;
+
+        }
+
+        if (distance_2 <= RAYON_ALIGNEMENT_2) {
+
+            acc.alignement.x += voisins.vel_x[k];
+            acc.alignement.y += voisins.vel_y[k];
+            acc.nb_alignement += 1;
+
+        }
+
+        if (distance_2 <= RAYON_COHESION_2) {
+
+            acc.cohesion.x -= dx;
+            acc.cohesion.y -= dy;
+            acc.nb_cohesion += 1;
+
+        }
+
+    }
+
+}
+
+static sf::Vector2f forces(const Accumulateurs& acc, float vx, float vy) {
+
+    sf::Vector2f acceleration(0.0f, 0.0f);
+
+    if (acc.nb_separation > 0) {
+
+        sf::Vector2f moyenne = acc.separation / acc.nb_separation;
+        acceleration += normalize(moyenne) * (FORCE_MAX * POIDS_SEPARATION);
+
+    }
+
+    if (acc.nb_alignement > 0) {
+
+        sf::Vector2f f = acc.alignement / acc.nb_alignement - sf::Vector2f(vx, vy);
+        acceleration += normalize(f) * (FORCE_MAX * POIDS_ALIGNEMENT);
+
+    }
+
+    if (acc.nb_cohesion > 0) {
+
+        // Somme des écarts relatifs : moyenne(positions) - position
+        sf::Vector2f f = acc.cohesion / acc.nb_cohesion;
+        acceleration += normalize(f) * (FORCE_MAX * POIDS_COHESION);
+
+    }
+
+    return acceleration;
+
+}
+
+sf::Vector2f steer_scalar(float x, float y, float vx, float vy, const Voisins& voisins) {
+
+    Accumulateurs acc = {};
+    accumuler(acc, x, y, voisins, 0);
+    return forces(acc, vx, vy);
+
+}
+
+#if STEERING_X86
+
+static float somme_horizontale(__m128 v) {
+
+    __m128 paires = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(paires, _mm_shuffle_ps(paires, paires, 1)));
+
+}
+
+__attribute__((target("avx2,fma")))
+static float somme_horizontale(__m256 v) {
+
+    return somme_horizontale(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+
+}
+
+// ecart_tore sur 8 et 4 voies, mêmes comparaisons et mêmes arrondis
+__attribute__((target("avx2,fma")))
+static __m256 ecart_tore(__m256 ecart, float taille) {
+
+    const __m256 periode = _mm256_set1_ps(taille);
+    ecart = _mm256_sub_ps(ecart, _mm256_and_ps(_mm256_cmp_ps(ecart, _mm256_set1_ps(taille / 2), _CMP_GT_OQ), periode));
+    return _mm256_add_ps(ecart, _mm256_and_ps(_mm256_cmp_ps(ecart, _mm256_set1_ps(-taille / 2), _CMP_LT_OQ), periode));
+
+}
+
+static __m128 ecart_tore(__m128 ecart, float taille) {
+
+    const __m128 periode = _mm_set1_ps(taille);
+    ecart = _mm_sub_ps(ecart, _mm_and_ps(_mm_cmpgt_ps(ecart, _mm_set1_ps(taille / 2)), periode));
+    return _mm_add_ps(ecart, _mm_and_ps(_mm_cmplt_ps(ecart, _mm_set1_ps(-taille / 2)), periode));
+
+}
+
+// 8 voisins par itération : les tests de rayon deviennent des masques
+__attribute__((target("avx2,fma")))
+static sf::Vector2f steer_avx2(float x, float y, float vx, float vy, const Voisins& voisins) {
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 un = _mm256_set1_ps(1.0f);
+    const __m256 px = _mm256_set1_ps(x);
+    const __m256 py = _mm256_set1_ps(y);
+    const __m256 rayon_separation = _mm256_set1_ps(RAYON_SEPARATION_2);
+    const __m256 rayon_alignement = _mm256_set1_ps(RAYON_ALIGNEMENT_2);
+    const __m256 rayon_cohesion = _mm256_set1_ps(RAYON_COHESION_2);
+
+    __m256 sep_x = zero, sep_y = zero, nb_sep = zero;
+    __m256 ali_x = zero, ali_y = zero, nb_ali = zero;
+    __m256 coh_x = zero, coh_y = zero, nb_coh = zero;
+
+    size_t k = 0;
+
+    for (; k + 8 <= voisins.size(); k += 8) {
+
+        __m256 dx = ecart_tore(_mm256_sub_ps(px, _mm256_loadu_ps(&voisins.pos_x[k])), LARGEUR);
+        __m256 dy = ecart_tore(_mm256_sub_ps(py, _mm256_loadu_ps(&voisins.pos_y[k])), HAUTEUR);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+        __m256 valide = _mm256_cmp_ps(d2, zero, _CMP_GT_OQ);
+        __m256 m_sep = _mm256_and_ps(valide, _mm256_cmp_ps(d2, rayon_separation, _CMP_LE_OQ));
+        __m256 m_ali = _mm256_and_ps(valide, _mm256_cmp_ps(d2, rayon_alignement, _CMP_LE_OQ));
+        __m256 m_coh = _mm256_and_ps(valide, _mm256_cmp_ps(d2, rayon_cohesion, _CMP_LE_OQ));
+
+        __m256 distance = _mm256_sqrt_ps(d2);
+        sep_x = _mm256_add_ps(sep_x, _mm256_and_ps(m_sep, _mm256_div_ps(dx, distance)));
+        sep_y = _mm256_add_ps(sep_y, _mm256_and_ps(m_sep, _mm256_div_ps(dy, distance)));
+        nb_sep = _mm256_add_ps(nb_sep, _mm256_and_ps(m_sep, un));
+
+        ali_x = _mm256_add_ps(ali_x, _mm256_and_ps(m_ali, _mm256_loadu_ps(&voisins.vel_x[k])));
+        ali_y = _mm256_add_ps(ali_y, _mm256_and_ps(m_ali, _mm256_loadu_ps(&voisins.vel_y[k])));
+        nb_ali = _mm256_add_ps(nb_ali, _mm256_and_ps(m_ali, un));
+
+        coh_x = _mm256_sub_ps(coh_x, _mm256_and_ps(m_coh, dx));
+        coh_y = _mm256_sub_ps(coh_y, _mm256_and_ps(m_coh, dy));
+        nb_coh = _mm256_add_ps(nb_coh, _mm256_and_ps(m_coh, un));
+
+    }
+
+    Accumulateurs acc = {
+        sf::Vector2f(somme_horizontale(sep_x), somme_horizontale(sep_y)),
+        sf::Vector2f(somme_horizontale(ali_x), somme_horizontale(ali_y)),
+        sf::Vector2f(somme_horizontale(coh_x), somme_horizontale(coh_y)),
+        somme_horizontale(nb_sep), somme_horizontale(nb_ali), somme_horizontale(nb_coh)
+    };
+
+    accumuler(acc, x, y, voisins, k);
+    return forces(acc, vx, vy);
+
+}
+
+// Même noyau sur 4 voisins, SSE2 étant toujours présent en x86-64
+static sf::Vector2f steer_sse(float x, float y, float vx, float vy, const Voisins& voisins) {
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 un = _mm_set1_ps(1.0f);
+    const __m128 px = _mm_set1_ps(x);
+    const __m128 py = _mm_set1_ps(y);
+    const __m128 rayon_separation = _mm_set1_ps(RAYON_SEPARATION_2);
+    const __m128 rayon_alignement = _mm_set1_ps(RAYON_ALIGNEMENT_2);
+    const __m128 rayon_cohesion = _mm_set1_ps(RAYON_COHESION_2);
+
+    __m128 sep_x = zero, sep_y = zero, nb_sep = zero;
+    __m128 ali_x = zero, ali_y = zero, nb_ali = zero;
+    __m128 coh_x = zero, coh_y = zero, nb_coh = zero;
+
+    size_t k = 0;
+
+    for (; k + 4 <= voisins.size(); k += 4) {
+
+        __m128 dx = ecart_tore(_mm_sub_ps(px, _mm_loadu_ps(&voisins.pos_x[k])), LARGEUR);
+        __m128 dy = ecart_tore(_mm_sub_ps(py, _mm_loadu_ps(&voisins.pos_y[k])), HAUTEUR);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+        __m128 valide = _mm_cmpgt_ps(d2, zero);
+        __m128 m_sep = _mm_and_ps(valide, _mm_cmple_ps(d2, rayon_separation));
+        __m128 m_ali = _mm_and_ps(valide, _mm_cmple_ps(d2, rayon_alignement));
+        __m128 m_coh = _mm_and_ps(valide, _mm_cmple_ps(d2, rayon_cohesion));
+
+        __m128 distance = _mm_sqrt_ps(d2);
+        sep_x = _mm_add_ps(sep_x, _mm_and_ps(m_sep, _mm_div_ps(dx, distance)));
+        sep_y = _mm_add_ps(sep_y, _mm_and_ps(m_sep, _mm_div_ps(dy, distance)));
+        nb_sep = _mm_add_ps(nb_sep, _mm_and_ps(m_sep, un));
+
+        ali_x = _mm_add_ps(ali_x, _mm_and_ps(m_ali, _mm_loadu_ps(&voisins.vel_x[k])));
+        ali_y = _mm_add_ps(ali_y, _mm_and_ps(m_ali, _mm_loadu_ps(&voisins.vel_y[k])));
+        nb_ali = _mm_add_ps(nb_ali, _mm_and_ps(m_ali, un));
+
+        coh_x = _mm_sub_ps(coh_x, _mm_and_ps(m_coh, dx));
+        coh_y = _mm_sub_ps(coh_y, _mm_and_ps(m_coh, dy));
+        nb_coh = _mm_add_ps(nb_coh, _mm_and_ps(m_coh, un));
+
+    }
+
+    Accumulateurs acc = {
+        sf::Vector2f(somme_horizontale(sep_x), somme_horizontale(sep_y)),
+        sf::Vector2f(somme_horizontale(ali_x), somme_horizontale(ali_y)),
+        sf::Vector2f(somme_horizontale(coh_x), somme_horizontale(coh_y)),
+        somme_horizontale(nb_sep), somme_horizontale(nb_ali), somme_horizontale(nb_coh)
+    };
+
+    accumuler(acc, x, y, voisins, k);
+    return forces(acc, vx, vy);
+
+}
+
+#endif
+
+static Kernel choisir_noyau() {
+
+#if STEERING_X86
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return steer_avx2;
+    return steer_sse;
+#else
+    return steer_scalar;
+#endif
+
+}
+
+static const Kernel noyau = choisir_noyau();
+
+const char* steering_path() {
+
+#if STEERING_X86
+    if (noyau == steer_avx2) return "avx2";
+    if (noyau == steer_sse) return "sse";
+#endif
+    return "scalar";
+
+}
+
+std::vector<std::pair<const char*, Kernel>> steering_kernels() {
+
+    std::vector<std::pair<const char*, Kernel>> noyaux = {{"scalar", steer_scalar}};
+
+#if STEERING_X86
+    noyaux.push_back({"sse", steer_sse});
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) noyaux.push_back({"avx2", steer_avx2});
+#endif
+
+    return noyaux;
+
+}
+
+sf::Vector2f steer(float x, float y, float vx, float vy, const Voisins& voisins) {
+
+    return noyau(x, y, vx, vy, voisins);
+
+}
+
+sf::Vector2f avoidance(float x, float y, const ObstacleField& obstacles) {
+
+    sf::Vector2f gradient;
+    float distance = obstacles.sample(x, y, gradient);
+
+    if (distance >= RAYON_OBSTACLE) return sf::Vector2f(0.0f, 0.0f);
+
+    float intensite = std::min(1.0f, 1.0f - distance / RAYON_OBSTACLE);
+    return gradient * (FORCE_MAX * POIDS_OBSTACLE * intensite);
+
+}
+
+void integrate(float& x, float& y, float& vx, float& vy, float ax, float ay) {
+
+    sf::Vector2f vitesse(vx + ax, vy + ay);
+    float norme = length(vitesse);
+
+    if (norme > VITESSE_MAX) {
+
+        vitesse = normalize(vitesse) * VITESSE_MAX;
+
+    }
+
+    else if (norme < VITESSE_MIN && norme > 0) {
+
+        vitesse = normalize(vitesse) * VITESSE_MIN;
+
+    }
+
+    x += vitesse.x;
+    y += vitesse.y;
+
+    if (x >= WINDOW_WIDTH) x = 0;
+    else if (x < 0) x = WINDOW_WIDTH;
+
+    if (y >= WINDOW_HEIGHT) y = 0;
+    else if (y < 0) y = WINDOW_HEIGHT;
+
+    vx = vitesse.x;
+    vy = vitesse.y;
+
+}
@@ -0,0 +1,389 @@
+#include <cmath>
+#include <mutex>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "flock.h"
+#include "utils.h"
+#include "trajectory.h"
+
+constexpr char MAGIC_ENTETE[8] = "BOIDTRJ";
+constexpr char MAGIC_PIED[8] = "BOIDIDX";
+constexpr uint32_t VERSION_TRAJECTOIRE = 1;
+constexpr size_t TRAMES_EN_ATTENTE_MAX = 64;
+
+static uint16_t quantifier_position(float valeur, float taille) {
+
+    float u = std::min(std::max(valeur / taille, 0.0f), 1.0f);
+    return static_cast<uint16_t>(std::lround(u * 65535.0f));
+
+}
+
+static float dequantifier_position(uint16_t valeur, float taille) {
+
+    return valeur * (taille / 65535.0f);
+
+}
+
+static int16_t quantifier_vitesse(float valeur, float vitesse_max) {
+
+    float u = std::min(std::max(valeur / vitesse_max, -1.0f), 1.0f);
+    return static_cast<int16_t>(std::lround(u * 32767.0f));
+
+}
+
+static float dequantifier_vitesse(int16_t valeur, float vitesse_max) {
+
+    return valeur * (vitesse_max / 32767.0f);
+
+}
+
+TrajectoryWriter::TrajectoryWriter() : fichier(nullptr), quantifie(false), offset(0), arret(false), erreur(false) {}
+
+TrajectoryWriter::~TrajectoryWriter() {
+
+    close();
+
+}
+
+bool TrajectoryWriter::open(const std::string& chemin, bool quantifie) {
+
+    close();
+
+    fichier = std::fopen(chemin.c_str(), "wb");
+    if (!fichier) return false;
+
+    TrajectoryHeader entete = {};
+    std::memcpy(entete.magic, MAGIC_ENTETE, sizeof(entete.magic));
+    entete.version = VERSION_TRAJECTOIRE;
+    entete.quantifie = quantifie;
+    entete.window_width = WINDOW_WIDTH;
+    entete.window_height = WINDOW_HEIGHT;
+    entete.vitesse_init = VITESSE_INIT;
+    entete.vitesse_max = VITESSE_MAX;
+    entete.vitesse_min = VITESSE_MIN;
+    entete.force_max = FORCE_MAX;
+    entete.rayon_separation = RAYON_SEPARATION;
+    entete.rayon_alignement = RAYON_ALIGNEMENT;
+    entete.rayon_cohesion = RAYON_COHESION;
+    entete.poids_separation = POIDS_SEPARATION;
+    entete.poids_cohesion = POIDS_COHESION;
+    entete.poids_alignement = POIDS_ALIGNEMENT;
+
+    if (std::fwrite(&entete, sizeof(entete), 1, fichier) != 1) {
+
+        std::fclose(fichier);
+        fichier = nullptr;
+        return false;
+
+    }
+
+    this->quantifie = quantifie;
+    offset = sizeof(entete);
+    index.clear();
+    arret = false;
+    erreur = false;
+    ecrivain = std::thread(&TrajectoryWriter::boucle, this);
+
+    return true;
+
+}
+
+bool TrajectoryWriter::is_open() const {
+
+    return fichier != nullptr;
+
+}
+
+void TrajectoryWriter::push(const FlockState& etat) {
+
+    if (!fichier) return;
+
+    size_t n = etat.size();
+    std::vector<float> trame;
+
+    {
+        // Le thread de simulation n'attend que si l'écriture a pris beaucoup de retard
+        std::unique_lock<std::mutex> verrou(mutex);
+        place_libre.wait(verrou, [&] { return file.size() < TRAMES_EN_ATTENTE_MAX; });
+
+        if (!libres.empty()) {
+
+            trame = std::move(libres.back());
+            libres.pop_back();
+
+        }
+    }
+
+    trame.resize(4 * n);
+    std::copy(etat.pos_x.begin(), etat.pos_x.end(), trame.begin());
+    std::copy(etat.pos_y.begin(), etat.pos_y.end(), trame.begin() + n);
+    std::copy(etat.vel_x.begin(), etat.vel_x.end(), trame.begin() + 2 * n);
+    std::copy(etat.vel_y.begin(), etat.vel_y.end(), trame.begin() + 3 * n);
+
+    {
+        std::lock_guard<std::mutex> verrou(mutex);
+        file.push_back(std::move(trame));
+    }
+
+    trame_prete.notify_one();
+
+}
+
+bool TrajectoryWriter::ecrire(const std::vector<float>& trame) {
+
+    uint32_t n = trame.size() / 4;
+    uint32_t entete_trame[2] = {n, 0};
+
+    index.push_back(offset);
+    if (std::fwrite(entete_trame, sizeof(entete_trame), 1, fichier) != 1) return false;
+    offset += sizeof(entete_trame);
+
+    if (quantifie) {
+
+        std::vector<uint16_t> positions(2 * n);
+        std::vector<int16_t> vitesses(2 * n);
+
+        for (uint32_t i = 0; i < n; i ++) {
+
+            positions[i] = quantifier_position(trame[i], WINDOW_WIDTH);
+            positions[n + i] = quantifier_position(trame[n + i], WINDOW_HEIGHT);
+            vitesses[i] = quantifier_vitesse(trame[2 * n + i], VITESSE_MAX);
+            vitesses[n + i] = quantifier_vitesse(trame[3 * n + i], VITESSE_MAX);
+
+        }
+
+        if (std::fwrite(positions.data(), sizeof(uint16_t), positions.size(), fichier) != positions.size()) return false;
+        if (std::fwrite(vitesses.data(), sizeof(int16_t), vitesses.size(), fichier) != vitesses.size()) return false;
+        offset += 4 * sizeof(uint16_t) * n;
+
+    }
+
+    else {
+
+        if (std::fwrite(trame.data(), sizeof(float), trame.size(), fichier) != trame.size()) return false;
+        offset += sizeof(float) * trame.size();
+
+    }
+
+    // Garde les trames alignées sur 8 octets
+    static const uint8_t zeros[8] = {};
+    size_t bourrage = (8 - offset % 8) % 8;
+    if (std::fwrite(zeros, 1, bourrage, fichier) != bourrage) return false;
+    offset += bourrage;
+
+    return true;
+
+}
+
+void TrajectoryWriter::boucle() {
+
+    while (true) {
+
+        std::vector<float> trame;
+
+        {
+            std::unique_lock<std::mutex> verrou(mutex);
+            trame_prete.wait(verrou, [&] { return arret || !file.empty(); });
+            if (file.empty()) return;
+
+            trame = std::move(file.front());
+            file.pop_front();
+        }
+
+        place_libre.notify_one();
+
+        // Après un échec les trames sont consommées sans être écrites
+        if (!erreur && !ecrire(trame)) erreur = true;
+
+        std::lock_guard<std::mutex> verrou(mutex);
+        libres.push_back(std::move(trame));
+
+    }
+
+}
+
+bool TrajectoryWriter::close() {
+
+    if (!fichier) return true;
+
+    {
+        std::lock_guard<std::mutex> verrou(mutex);
+        arret = true;
+    }
+
+    // Le thread vide la file avant de s'arrêter
+    trame_prete.notify_one();
+    ecrivain.join();
+
+    TrajectoryFooter pied = {};
+    pied.nb_frames = index.size();
+    pied.offset_index = offset;
+    std::memcpy(pied.magic, MAGIC_PIED, sizeof(pied.magic));
+
+    // Sans pied, le lecteur refusera le fichier plutôt que de lire des trames tronquées
+    bool valide = !erreur;
+    if (valide) valide = std::fwrite(index.data(), sizeof(uint64_t), index.size(), fichier) == index.size();
+    if (valide) valide = std::fwrite(&pied, sizeof(pied), 1, fichier) == 1;
+    if (std::fclose(fichier) != 0) valide = false;
+
+    fichier = nullptr;
+    file.clear();
+    libres.clear();
+
+    return valide;
+
+}
+
+TrajectoryReader::TrajectoryReader() : donnees(nullptr), taille(0), entete(nullptr), index(nullptr), nb_frames(0), fin_trames(0) {}
+
+TrajectoryReader::~TrajectoryReader() {
+
+    close();
+
+}
+
+bool TrajectoryReader::open(const std::string& chemin) {
+
+    close();
+
+    int fd = ::open(chemin.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat infos;
+
+    if (fstat(fd, &infos) != 0 || static_cast<size_t>(infos.st_size) < sizeof(TrajectoryHeader) + sizeof(TrajectoryFooter)) {
+
+        ::close(fd);
+        return false;
+
+    }
+
+    void* carte = mmap(nullptr, infos.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (carte == MAP_FAILED) return false;
+
+    donnees = static_cast<const uint8_t*>(carte);
+    taille = infos.st_size;
+
+    entete = reinterpret_cast<const TrajectoryHeader*>(donnees);
+    const TrajectoryFooter* pied = reinterpret_cast<const TrajectoryFooter*>(donnees + taille - sizeof(TrajectoryFooter));
+
+    // Aucune somme sur des valeurs lues dans le fichier : offset_index est
+    // borné par place et nb_frames avant la multiplication, rien ne déborde
+    uint64_t place = taille - sizeof(TrajectoryFooter);
+
+    bool valide = std::memcmp(entete->magic, MAGIC_ENTETE, sizeof(entete->magic)) == 0
+        && entete->version == VERSION_TRAJECTOIRE
+        && std::memcmp(pied->magic, MAGIC_PIED, sizeof(pied->magic)) == 0
+        && pied->offset_index >= sizeof(TrajectoryHeader)
+        && pied->offset_index % 8 == 0
+        && pied->offset_index <= place
+        && pied->nb_frames <= place / sizeof(uint64_t)
+        && place - pied->offset_index == pied->nb_frames * sizeof(uint64_t);
+
+    if (!valide) {
+
+        close();
+        return false;
+
+    }
+
+    index = reinterpret_cast<const uint64_t*>(donnees + pied->offset_index);
+    nb_frames = pied->nb_frames;
+    fin_trames = pied->offset_index;
+
+    // Chaque trame commence, alignée, après l'entête et avant l'index
+    for (size_t k = 0; k < nb_frames; k ++) {
+
+        if (index[k] < sizeof(TrajectoryHeader) || index[k] % 8 != 0 || index[k] > fin_trames - 2 * sizeof(uint32_t)) {
+
+            close();
+            return false;
+
+        }
+
+    }
+
+    return true;
+
+}
+
+void TrajectoryReader::close() {
+
+    if (donnees) munmap(const_cast<uint8_t*>(donnees), taille);
+
+    donnees = nullptr;
+    taille = 0;
+    entete = nullptr;
+    index = nullptr;
+    nb_frames = 0;
+    fin_trames = 0;
+
+}
+
+size_t TrajectoryReader::frame_count() const {
+
+    return nb_frames;
+
+}
+
+const TrajectoryHeader& TrajectoryReader::header() const {
+
+    return *entete;
+
+}
+
+bool TrajectoryReader::frame(size_t k, FlockState& etat) const {
+
+    if (k >= nb_frames) return false;
+
+    const uint8_t* trame = donnees + index[k];
+    uint32_t n = *reinterpret_cast<const uint32_t*>(trame);
+
+    // Une trame annoncée plus longue que la place restante est corrompue
+    uint64_t octets = uint64_t(n) * (entete->quantifie ? 4 * sizeof(uint16_t) : 4 * sizeof(float));
+    if (octets > fin_trames - index[k] - 2 * sizeof(uint32_t)) return false;
+
+    trame += 2 * sizeof(uint32_t);
+
+    etat.resize(n);
+    std::fill(etat.acc_x.begin(), etat.acc_x.end(), 0.0f);
+    std::fill(etat.acc_y.begin(), etat.acc_y.end(), 0.0f);
+
+    if (entete->quantifie) {
+
+        const uint16_t* positions = reinterpret_cast<const uint16_t*>(trame);
+        const int16_t* vitesses = reinterpret_cast<const int16_t*>(positions + 2 * n);
+
+        for (uint32_t i = 0; i < n; i ++) {
+
+            etat.pos_x[i] = dequantifier_position(positions[i], entete->window_width);
+            etat.pos_y[i] = dequantifier_position(positions[n + i], entete->window_height);
+            etat.vel_x[i] = dequantifier_vitesse(vitesses[i], entete->vitesse_max);
+            etat.vel_y[i] = dequantifier_vitesse(vitesses[n + i], entete->vitesse_max);
+
+        }
+
+    }
+
+    else {
+
+        const float* valeurs = reinterpret_cast<const float*>(trame);
+        std::copy(valeurs, valeurs + n, etat.pos_x.begin());
+        std::copy(valeurs + n, valeurs + 2 * n, etat.pos_y.begin());
+        std::copy(valeurs + 2 * n, valeurs + 3 * n, etat.vel_x.begin());
+        std::copy(valeurs + 3 * n, valeurs + 4 * n, etat.vel_y.begin());
+
+    }
+
+    return true;
+
+}
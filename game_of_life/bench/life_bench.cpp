@@ -0,0 +1,398 @@
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "grid.h"
+#include "utils.h"
+
+// Usage : life_bench [generations] [threads] [seed] [motif|kernels]
+// Un processus par mesure, pour que peak_rss_kb ne compte que ce moteur ;
+// sortie CSV sur stdout, sans fenêtre. Code de retour non nul si une
+// vérification échoue
+
+// Une mesure s'arrête après ce temps même si toutes les générations ne
+// sont pas faites ; generations donne alors ce qui a été calculé
+constexpr double TEMPS_MAX = 5.0;
+
+// Pic mémoire toléré pour HashLife : sa limite, plus les tableaux de marques
+// et de renumérotation de la collecte et le reste du processus
+constexpr size_t RSS_MAX_HASHLIFE = HASHLIFE_MEMOIRE + HASHLIFE_MEMOIRE / 4;
+
+struct Motif {
+
+    const char* nom;
+    vector<const char*> lignes;
+
+};
+
+static const Motif R_PENTOMINO = {"rpentomino", {
+    ".OO",
+    "OO.",
+    ".O.",
+}};
+
+static const Motif ACORN = {"acorn", {
+    ".O.....",
+    "...O...",
+    "OO..OOO",
+}};
+
+static const Motif GOSPER = {"gosper", {
+    "........................O...........",
+    "......................O.O...........",
+    "............OO......OO............OO",
+    "...........O...O....OO............OO",
+    "OO........O.....O...OO..............",
+    "OO........O...O.OO....O.O...........",
+    "..........O.....O.......O...........",
+    "...........O...O....................",
+    "............OO......................",
+}};
+
+struct Scenario {
+
+    const Motif* motif;
+    int lignes, colonnes;
+    double densite;
+
+};
+
+struct Mesure {
+
+    Moteur moteur;
+    int exposant;
+
+};
+
+static const char* nom_moteur(Moteur moteur) {
+
+    if (moteur == Moteur::HASHLIFE) return "hashlife";
+    if (moteur == Moteur::INFINI) return "infini";
+    return "dense";
+
+}
+
+static string nom_scenario(const Scenario& s) {
+
+    return s.motif ? s.motif->nom : "soup";
+
+}
+
+// Motif centré sur le plateau, ou soupe aléatoire sur tout le plateau
+static void remplir(Grid& grid, const Scenario& s, unsigned long seed) {
+
+    if (s.motif) {
+
+        int y = s.lignes / 2 - static_cast<int>(s.motif->lignes.size()) / 2;
+        int x = s.colonnes / 2 - static_cast<int>(std::string(s.motif->lignes[0]).size()) / 2;
+
+        for (size_t r = 0; r < s.motif->lignes.size(); r ++) {
+            for (size_t c = 0; s.motif->lignes[r][c]; c ++) {
+
+                if (s.motif->lignes[r][c] == 'O') grid.set_cell(y + r, x + c, true);
+
+            }
+
+        }
+
+        return;
+
+    }
+
+    std::mt19937_64 generateur(seed);
+    std::bernoulli_distribution vivante(s.densite);
+
+    for (int r = 0; r < s.lignes; r ++) {
+        for (int c = 0; c < s.colonnes; c ++) {
+
+            if (vivante(generateur)) grid.set_cell(r, c, true);
+
+        }
+
+    }
+
+}
+
+// Moteur dense face à count_voisins / apply_rules, génération par génération
+static bool verifier_dense(const Scenario& s, unsigned nb_threads, unsigned long seed, int nb_generations) {
+
+    Grid grid(s.lignes, s.colonnes, nb_threads);
+    remplir(grid, s, seed);
+
+    for (int g = 0; g < nb_generations; g ++) {
+
+        set<pair<int, int>> attendu;
+
+        for (int r = 0; r < s.lignes; r ++) {
+            for (int c = 0; c < s.colonnes; c ++) {
+
+                if (grid.apply_rules(r, c, grid.count_voisins(r, c))) attendu.insert(attendu.end(), {r, c});
+
+            }
+
+        }
+
+        grid.update();
+
+        if (grid.get_cels() != attendu) return false;
+
+    }
+
+    return true;
+
+}
+
+// Chaque noyau de bande face à count_voisins / apply_rules, sur des tailles
+// qui ne sont pas des multiples de 64 (bits de bourrage, masque_fin) et des
+// densités assez faibles pour que des tuiles soient sautées
+constexpr int GENERATIONS_NOYAUX = 32;
+
+static bool verifier_noyaux(unsigned nb_threads, unsigned long seed) {
+
+    static const int tailles[][2] = {
+        {1, 1}, {1, 64}, {2, 65}, {3, 63}, {63, 65}, {64, 64},
+        {65, 129}, {100, 200}, {37, 257}, {128, 300}, {200, 511}, {150, 1000},
+    };
+
+    vector<pair<const char*, BandKernel>> noyaux = update_kernels();
+    string noms;
+
+    for (auto [nom, noyau] : noyaux) noms += string(noms.empty() ? "" : "+") + nom;
+
+    std::printf("rows,cols,density,generations,kernels,check\n");
+
+    bool valide = true;
+
+    for (auto [lignes, colonnes] : tailles) {
+        for (double densite : {0.02, 0.2, 0.45}) {
+
+            Scenario s = {nullptr, lignes, colonnes, densite};
+            // Une grille par noyau, toutes depuis la même soupe
+            vector<unique_ptr<Grid>> grilles;
+
+            for (auto [nom, noyau] : noyaux) {
+
+                grilles.push_back(std::make_unique<Grid>(lignes, colonnes, nb_threads));
+                grilles.back()->set_kernel(noyau);
+                remplir(*grilles.back(), s, seed);
+
+            }
+
+            bool ok = true;
+            int g = 0;
+
+            for (; g < GENERATIONS_NOYAUX && ok; g ++) {
+
+                Grid& reference = *grilles.front();
+                set<pair<int, int>> attendu;
+
+                for (int r = 0; r < lignes; r ++) {
+                    for (int c = 0; c < colonnes; c ++) {
+
+                        if (reference.apply_rules(r, c, reference.count_voisins(r, c))) attendu.insert(attendu.end(), {r, c});
+
+                    }
+
+                }
+
+                for (auto& grille : grilles) {
+
+                    grille->update();
+                    ok = ok && grille->get_cels() == attendu;
+
+                }
+
+            }
+
+            valide = valide && ok;
+
+            std::printf("%d,%d,%.2f,%d,%s,%s\n", lignes, colonnes, densite, g, noms.c_str(), ok ? "ok" : "FAIL");
+
+        }
+
+    }
+
+    return valide;
+
+}
+
+// Les deux moteurs sur plan infini doivent rester identiques
+static bool verifier_infini(const Scenario& s, unsigned nb_threads, unsigned long seed, int nb_generations) {
+
+    Grid hashlife(s.lignes, s.colonnes, nb_threads);
+    Grid plan(s.lignes, s.colonnes, nb_threads);
+
+    hashlife.set_engine(Moteur::HASHLIFE);
+    plan.set_engine(Moteur::INFINI);
+
+    remplir(hashlife, s, seed);
+    remplir(plan, s, seed);
+
+    for (int g = 0; g < nb_generations; g ++) {
+
+        hashlife.update();
+        plan.update();
+
+    }
+
+    return hashlife.get_cels() == plan.get_cels();
+
+}
+
+static bool mesurer(const Scenario& s, const Mesure& m, uint64_t nb_generations, unsigned nb_threads, unsigned long seed) {
+
+    Grid grid(s.lignes, s.colonnes, nb_threads);
+    grid.set_engine(m.moteur);
+    grid.set_step(m.exposant);
+    remplir(grid, s, seed);
+
+    auto debut = std::chrono::steady_clock::now();
+    double total_s = 0.0;
+
+    while (grid.get_generation() < nb_generations && total_s < TEMPS_MAX) {
+
+        grid.update();
+        total_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+
+    }
+
+    uint64_t generations = grid.get_generation();
+    uint64_t population = grid.get_len_cels();
+
+    // Avant les vérifications, qui allouent leurs propres grilles
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    size_t actives = grid.get_active_tiles();
+    size_t sautees = grid.get_skipped_tiles();
+
+    // Vérification courte, une fois par scénario
+    const char* verification = "-";
+
+    if (m.exposant == 0) {
+
+        int n = s.motif || static_cast<int64_t>(s.lignes) * s.colonnes <= 1024 * 1024 ? 8 : 2;
+
+        if (m.moteur == Moteur::DENSE) verification = verifier_dense(s, nb_threads, seed, n) ? "ok" : "FAIL";
+        if (m.moteur == Moteur::INFINI) verification = verifier_infini(s, nb_threads, seed, n) ? "ok" : "FAIL";
+
+    }
+
+    if (m.moteur == Moteur::HASHLIFE) verification = size_t(usage.ru_maxrss) * 1024 <= RSS_MAX_HASHLIFE ? "ok" : "FAIL";
+
+    // Cellules du plateau x générations : l'équivalent dense du travail fait
+    double generations_s = total_s > 0.0 ? generations / total_s : 0.0;
+    double cellules_s = generations_s * s.lignes * s.colonnes;
+
+    std::printf("%s,%d,%d,%.2f,%s,%s,%d,%u,%llu,%.6f,%.1f,%.4g,%llu,%zu,%zu,%ld,%s\n",
+                nom_scenario(s).c_str(), s.lignes, s.colonnes, s.densite, nom_moteur(m.moteur),
+                m.moteur == Moteur::DENSE ? update_path() : "-", m.exposant, nb_threads,
+                static_cast<unsigned long long>(generations), total_s, generations_s, cellules_s,
+                static_cast<unsigned long long>(population), actives, sautees, usage.ru_maxrss, verification);
+
+    return std::string(verification) != "FAIL";
+
+}
+
+int main(int argc, char** argv) {
+
+    uint64_t nb_generations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    unsigned nb_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    unsigned long seed = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 42;
+    std::string filtre = argc > 4 ? argv[4] : "";
+
+    nb_generations = std::max<uint64_t>(nb_generations, 1);
+    nb_threads = std::max(nb_threads, 1u);
+
+    if (filtre == "kernels") return verifier_noyaux(nb_threads, seed) ? 0 : 1;
+
+    vector<Scenario> scenarios = {
+        {&R_PENTOMINO, 1024, 1024, 0.0},
+        {&GOSPER, 512, 512, 0.0},
+        {&ACORN, 1024, 1024, 0.0},
+    };
+
+    // 250 et 1000 : dernier mot partiel, comme sur la plupart des plateaux
+    for (int taille : {250, 512, 1000}) {
+        for (double densite : {0.1, 0.33, 0.5}) {
+
+            scenarios.push_back({nullptr, taille, taille, densite});
+
+        }
+
+    }
+
+    // HashLife pas à pas, puis par sauts de 2^k générations
+    int saut = 0;
+    while ((uint64_t(2) << saut) <= nb_generations && saut < EXPOSANT_MAX) saut ++;
+
+    vector<Mesure> mesures = {
+        {Moteur::DENSE, 0},
+        {Moteur::INFINI, 0},
+        {Moteur::HASHLIFE, 0},
+        {Moteur::HASHLIFE, saut},
+    };
+
+    std::printf("pattern,rows,cols,density,engine,kernel,step,threads,generations,seconds,"
+                "generations_per_s,cell_updates_per_s,population,active_tiles,skipped_tiles,peak_rss_kb,check\n");
+
+    bool valide = true;
+
+    for (const Scenario& s : scenarios) {
+
+        if (!filtre.empty() && nom_scenario(s) != filtre) continue;
+
+        for (const Mesure& m : mesures) {
+
+            if (m.exposant && !saut) continue;
+
+            // Sinon le tampon de stdout serait recopié dans l'enfant
+            std::fflush(stdout);
+
+            pid_t pid = fork();
+
+            if (pid < 0) {
+
+                std::perror("fork");
+                return 1;
+
+            }
+
+            if (pid == 0) {
+
+                bool ok = mesurer(s, m, nb_generations, nb_threads, seed);
+                std::fflush(stdout);
+                _exit(ok ? 0 : 1);
+
+            }
+
+            int statut = 0;
+            waitpid(pid, &statut, 0);
+
+            if (!WIFEXITED(statut)) {
+
+                std::fprintf(stderr, "%s %s : processus terminé anormalement\n", nom_scenario(s).c_str(), nom_moteur(m.moteur));
+
+            }
+
+            valide = valide && WIFEXITED(statut) && WEXITSTATUS(statut) == 0;
+
+        }
+
+    }
+
+    return valide ? 0 : 1;
+
+}
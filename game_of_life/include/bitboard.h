@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+
+// Logique de génération sur des mots de 64 cellules, partagée par les
+// moteurs à base de bits
+
+// Décalages d'une ligne de mots : bit j reçoit la colonne j - 1 (ouest)
+// ou j + 1 (est), avec la retenue du mot voisin
+inline uint64_t ouest(uint64_t mot, uint64_t precedent) {
+
+    return (mot << 1) | (precedent >> 63);
+
+}
+
+inline uint64_t est(uint64_t mot, uint64_t suivant) {
+
+    return (mot >> 1) | (suivant << 63);
+
+}
+
+// Additionneur complet sur 64 cellules à la fois
+inline void additionne(uint64_t a, uint64_t b, uint64_t c, uint64_t& somme, uint64_t& retenue) {
+
+    uint64_t ab = a ^ b;
+
+    somme = ab ^ c;
+    retenue = (a & b) | (c & ab);
+
+}
+
+// Génération suivante d'un mot à partir des trois lignes haut / milieu / bas.
+// Les huit voisins sont sommés sur trois bits (8 donne 0, mort comme 0) ;
+// une cellule vit si la somme vaut 3, ou 2 et qu'elle vivait déjà.
+inline uint64_t generation(const uint64_t* haut, const uint64_t* milieu, const uint64_t* bas, int w, int mots) {
+
+    uint64_t h = haut[w], m = milieu[w], b = bas[w];
+
+    uint64_t hp = w > 0 ? haut[w - 1] : 0, hs = w + 1 < mots ? haut[w + 1] : 0;
+    uint64_t mp = w > 0 ? milieu[w - 1] : 0, ms = w + 1 < mots ? milieu[w + 1] : 0;
+    uint64_t bp = w > 0 ? bas[w - 1] : 0, bs = w + 1 < mots ? bas[w + 1] : 0;
+
+    uint64_t h0, h1, b0, b1;
+    additionne(ouest(h, hp), h, est(h, hs), h0, h1);
+    additionne(ouest(b, bp), b, est(b, bs), b0, b1);
+
+    uint64_t mo = ouest(m, mp), me = est(m, ms);
+    uint64_t m0 = mo ^ me, m1 = mo & me;
+
+    uint64_t s0, r0, d0, d1;
+    additionne(h0, m0, b0, s0, r0);
+    additionne(h1, m1, b1, d0, d1);
+
+    uint64_t s1 = d0 ^ r0;
+    uint64_t s2 = d1 ^ (d0 & r0);
+
+    return s1 & ~s2 & (s0 | m);
+
+}
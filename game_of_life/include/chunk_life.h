@@ -0,0 +1,66 @@
+#pragma once
+#include "utils.h"
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+using namespace std;
+
+// Plan infini en morceaux de 64 x 64 cellules (un mot par ligne) rangés
+// dans une table indexée par leurs coordonnées. Un morceau est créé quand
+// l'activité l'atteint et libéré quand il est vide et stable, la mémoire
+// suit donc la population et non la boîte englobante.
+class ChunkLife {
+
+    private:
+
+        static constexpr int COTE = 64;
+
+        struct Chunk {
+
+            int64_t cx, cy;
+            uint64_t lignes[COTE];
+            uint64_t suivant[COTE];
+            bool modifie;
+
+        };
+
+        unordered_map<uint64_t, Chunk> chunks;
+
+        static uint64_t cle(int64_t cx, int64_t cy);
+
+        Chunk* trouver(int64_t cx, int64_t cy);
+
+        const Chunk* trouver(int64_t cx, int64_t cy) const;
+
+        Chunk& obtenir(int64_t cx, int64_t cy);
+
+    public:
+
+        // Les clés gardent 32 bits par coordonnée de morceau : au-delà de
+        // cette distance de l'origine, deux morceaux se confondraient
+        static constexpr int64_t LIMITE = int64_t(1) << 37;
+
+        void clear();
+
+        bool get_cell(int64_t row, int64_t col) const;
+
+        void set_cell(int64_t row, int64_t col, bool state);
+
+        void step();
+
+        // Superpose 64 lignes (un mot par ligne) au morceau (cy, cx)
+        void insert_block(int64_t cy, int64_t cx, const uint64_t* lignes);
+
+        uint64_t population() const;
+
+        size_t chunk_count() const;
+
+        size_t memory() const;
+
+        // Cellules vivantes de [r0, r1) x [c0, c1)
+        void cells(int64_t r0, int64_t c0, int64_t r1, int64_t c1, vector<pair<int64_t, int64_t>>& sortie) const;
+
+};
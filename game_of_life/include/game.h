@@ -2,6 +2,7 @@
 #include "grid.h"
 #include "utils.h"
 #include <SFML/Graphics.hpp>
+#include <string>
 
 class Game {
 
@@ -16,6 +17,8 @@ class Game {
 
         Game();
 
+        bool load_pattern(const string& chemin);
+
         void run();
 
         void update();
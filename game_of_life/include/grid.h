@@ -1,31 +1,96 @@
 #pragma once
 #include "utils.h"
+#include "hashlife.h"
+#include "chunk_life.h"
+#include "thread_pool.h"
 
 #include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
 #include <utility>
 #include <SFML/Graphics.hpp>
 
 using namespace std;
 
+// Moteur dense : plateau borné row x col, une génération par update.
+// HashLife : plan infini, 2^exposant générations par update.
+// Infini : plan infini en morceaux de 64 x 64, une génération par update.
+enum class Moteur { DENSE, HASHLIFE, INFINI };
+
+// Calcule les mots [debut, fin) des lignes [r0, r1) de la génération
+// suivante et accumule par mot les bits modifiés dans difference ; vide est
+// une ligne morte qui remplace les lignes hors du plateau
+using BandKernel = void(*)(const uint64_t* cels, uint64_t* suivant, uint64_t* difference, const uint64_t* vide, int r0, int r1, int row, int debut, int fin, int mots);
+
+// Noyau de génération utilisé par défaut par Grid::update : "avx2" ou "scalar"
+const char* update_path();
+
+// Noyaux exécutables sur ce processeur, le scalaire en premier
+vector<pair<const char*, BandKernel>> update_kernels();
+
 class Grid {
 
     private:
         
         int row, col;
-        int nb_generation;
-        set<pair<int, int>> cels;
+        uint64_t nb_generation;
+
+        Moteur moteur;
+        BandKernel noyau;
+        HashLife hashlife;
+        ChunkLife plan;
+        int exposant;
+
+        // 64 cellules par mot, bit j du mot w = colonne 64 * w + j ;
+        // lignes complétées à un multiple de 4 mots pour le noyau AVX2,
+        // les bits au-delà de col restent à zéro
+        int mots, dernier;
+        uint64_t masque_fin;
+        vector<uint64_t> cels, suivant;
+
+        // Tuiles de TAILLE_TUILE lignes x 1 mot : seules celles qui ont
+        // changé à la génération précédente, et leurs voisines, sont
+        // recalculées ; les autres sont identiques dans les deux tampons
+        int tuiles_x, tuiles_y;
+        vector<uint8_t> modifiees, a_calculer;
+        size_t nb_actives, nb_sautees;
+
+        // Tranches de LIGNES_TACHE lignes réparties entre les threads ;
+        // chaque tranche ne lit que cels et n'écrit que ses lignes de
+        // suivant et sa ligne de changements
+        ThreadPool threads;
+        int tranches;
+        vector<uint64_t> vide, changements;
+        vector<vector<pair<int, int>>> plages;
+
+        void mark_tile(int row, int col);
+
+        // Cellules vivantes du moteur actif, triées par ligne puis colonne
+        void live_cells(vector<pair<int64_t, int64_t>>& sortie);
+
+        void insert_block(int64_t by, int64_t bx, const uint64_t* lignes);
 
     public:
 
         Grid();
 
+        Grid(int row, int col, unsigned nb_threads = std::thread::hardware_concurrency());
+
         void clear();
 
         void update();
 
         int get_len_cels();
 
-        void insert_pattern();
+        // RLE ou macrocell (.mc) selon l'extension, lu directement dans la
+        // représentation du moteur actif ; (row, col) reçoit le coin haut
+        // gauche d'un RLE, l'origine (centre de la racine) d'un macrocell
+        bool insert_pattern(const string& chemin, int row, int col);
+
+        // Macrocell si le chemin finit par .mc, RLE sinon
+        bool save_pattern(const string& chemin);
 
         set<pair<int, int>> get_cels();
 
@@ -33,10 +98,31 @@ class Grid {
 
         void toggle_cell(int row, int col);
 
+        // Versions cellule par cellule, référence du noyau par mots
         int count_voisins(int row, int col);
 
         void draw(sf::RenderWindow& window);
 
+        // Transfère les cellules vers un autre moteur ; le passage en dense
+        // ne garde que ce qui tient dans le plateau
+        void set_engine(Moteur moteur);
+
+        Moteur get_engine() const;
+
+        void set_step(int exposant);
+
+        int get_step() const;
+
+        uint64_t get_generation() const;
+
+        // Tuiles recalculées / sautées à la dernière génération dense
+        size_t get_active_tiles() const;
+
+        size_t get_skipped_tiles() const;
+
+        // Remplace le noyau choisi à l'exécution, pour comparer les chemins
+        void set_kernel(BandKernel noyau);
+
         void set_cell(int row, int col, bool state);
 
         bool apply_rules(int row, int col, int nb_voisins);
@@ -0,0 +1,175 @@
+#pragma once
+#include "utils.h"
+
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <unordered_map>
+
+using namespace std;
+
+// Quadtree partagé (hash-consing) avec résultats mémorisés : un nœud de
+// niveau k couvre 2^k x 2^k cellules et connaît son centre avancé de 2^j
+// générations. Le plan est infini, centré sur l'origine.
+class HashLife {
+
+    private:
+
+        struct Noeud {
+
+            uint32_t nw, ne, sw, se;
+            uint32_t resultat;
+            uint32_t chaine;
+            uint64_t population;
+            int niveau;
+
+        };
+
+        static constexpr uint32_t AUCUN = UINT32_MAX;
+
+        // Nœuds par blocs de taille fixe : grandir alloue un bloc sans
+        // recopier les autres, là où un vector doublerait la mémoire le
+        // temps de la réallocation
+        class Reserve {
+
+            private:
+
+                static constexpr int DECALAGE = 16;
+                static constexpr size_t TAILLE_BLOC = size_t(1) << DECALAGE;
+
+                vector<unique_ptr<Noeud[]>> blocs;
+                size_t taille = 0;
+
+            public:
+
+                Noeud& operator[](size_t i) { return blocs[i >> DECALAGE][i & (TAILLE_BLOC - 1)]; }
+
+                const Noeud& operator[](size_t i) const { return blocs[i >> DECALAGE][i & (TAILLE_BLOC - 1)]; }
+
+                size_t size() const { return taille; }
+
+                size_t capacity() const { return blocs.size() * TAILLE_BLOC; }
+
+                void push_back(const Noeud& n) {
+
+                    if (taille == capacity()) blocs.emplace_back(new Noeud[TAILLE_BLOC]);
+                    (*this)[taille++] = n;
+
+                }
+
+                // Garde les n premiers nœuds et rend les blocs au-delà
+                void truncate(size_t n) {
+
+                    taille = n;
+                    blocs.resize((n + TAILLE_BLOC - 1) / TAILLE_BLOC);
+                    blocs.shrink_to_fit();
+
+                }
+
+        };
+
+        Reserve noeuds;
+        vector<uint32_t> table;
+        vector<uint32_t> vides;
+        unordered_map<uint64_t, uint32_t> feuilles;
+        size_t nb_vivants;
+
+        uint32_t racine;
+        int exposant_memo;
+
+        // Pendant un pas, creer vérifie la limite à chaque nouveau bloc de
+        // nœuds : au-delà, le pas est interrompu et successeur remonte sans
+        // rien mémoriser. exposant_sur : plus grand saut qui a tenu
+        bool borne, interrompu;
+        int exposant_sur;
+        size_t limite_octets;
+        size_t nb_collectes;
+
+        uint32_t creer(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+
+        uint32_t vide(int niveau);
+
+        uint32_t centre(uint32_t n);
+
+        uint32_t agrandir(uint32_t n);
+
+        uint32_t feuille(uint32_t n);
+
+        uint32_t successeur(uint32_t n, int j);
+
+        // Un saut de 2^exposant depuis la racine ; faux s'il a été interrompu
+        bool avancer(int exposant, bool limite);
+
+        uint32_t modifier(uint32_t n, int64_t x, int64_t y, bool etat);
+
+        uint32_t unir(uint32_t a, uint32_t b);
+
+        uint32_t inserer(uint32_t n, int64_t x, int64_t y, uint32_t motif);
+
+        void ecrire(FILE* fichier, uint32_t n, unordered_map<uint32_t, uint32_t>& numeros, uint32_t& suivant) const;
+
+        bool lire(uint32_t n, int64_t x, int64_t y) const;
+
+        void collecter(uint32_t n, int64_t x, int64_t y, int64_t r0, int64_t c0, int64_t r1, int64_t c1, vector<pair<int64_t, int64_t>>& sortie) const;
+
+        void marquer(uint32_t n, vector<bool>& marques) const;
+
+        void rehash(size_t taille);
+
+        // Renumérote les nœuds marqués en tête du tableau et rend le reste
+        void compacter(const vector<bool>& marques);
+
+        void garbage_collect();
+
+        // Agrandit la racine jusqu'à contenir (x, y)
+        void couvrir(int64_t x, int64_t y);
+
+    public:
+
+        HashLife(size_t limite_octets = HASHLIFE_MEMOIRE);
+
+        void clear();
+
+        bool get_cell(int64_t row, int64_t col) const;
+
+        void set_cell(int64_t row, int64_t col, bool state);
+
+        // Avance de 2^exposant générations. Un saut qui dépasse la limite
+        // mémoire est repris après collecte, puis coupé en sauts plus courts ;
+        // seul un pas d'une génération peut encore la dépasser, quand le
+        // motif seul n'y tient pas
+        void step(int exposant);
+
+        uint64_t population() const;
+
+        size_t node_count() const;
+
+        size_t memory() const;
+
+        size_t gc_count() const;
+
+        // Construction directe de nœuds, pour les chargeurs de motifs :
+        // feuille 8 x 8 (octet r = ligne r, bit c = colonne c), bloc de
+        // 64 x 64 (un mot par ligne), assemblage et nœud vide
+        uint32_t leaf(uint64_t bits);
+
+        uint32_t block(const uint64_t* lignes);
+
+        uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+
+        uint32_t empty(int niveau);
+
+        // Superpose le nœud au motif, coin haut gauche en (row, col) ; direct
+        // si la position est alignée sur sa taille, sinon par quarts
+        void insert(uint32_t noeud, int64_t row, int64_t col);
+
+        // Format macrocell, la racine gardant sa position centrée sur l'origine
+        bool save_macrocell(const string& chemin) const;
+
+        // Cellules vivantes de [r0, r1) x [c0, c1)
+        void cells(int64_t r0, int64_t c0, int64_t r1, int64_t c1, vector<pair<int64_t, int64_t>>& sortie) const;
+
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+using namespace std;
+
+// Fichier projeté en mémoire, en lecture seule
+class MappedFile {
+
+    private:
+
+        const char* donnees;
+        size_t taille;
+
+    public:
+
+        MappedFile();
+
+        ~MappedFile();
+
+        bool open(const string& chemin);
+
+        void close();
+
+        const char* begin() const;
+
+        const char* end() const;
+
+};
+
+// Reçoit un bloc de 64 x 64 cellules (un mot par ligne) dont le coin est
+// en (64 * by, 64 * bx)
+using BlockSink = function<void(int64_t by, int64_t bx, const uint64_t* lignes)>;
+
+// Côté maximal annoncé par l'entête d'un RLE
+constexpr uint64_t RLE_COTE_MAX = INT32_MAX;
+
+// RLE : le coin haut gauche du motif est placé en (row, col). Les lignes
+// arrivent dans l'ordre, on n'accumule donc qu'une bande de 64 lignes.
+// Refusé sans entête "x = .., y = .." ou si un compte sort de cette boîte.
+bool read_rle(const MappedFile& fichier, int64_t row, int64_t col, const BlockSink& bloc);
+
+// Nœud macrocell : feuille 8 x 8 (octet r = ligne r, bit c = colonne c)
+// ou nœud de niveau >= 4 dont les enfants sont des indices de lignes
+// précédentes, 0 pour un enfant vide
+struct MacroNode {
+
+    int niveau;
+    uint32_t enfants[4];
+    uint64_t feuille;
+
+};
+
+// Le dernier nœud est la racine
+bool read_macrocell(const MappedFile& fichier, vector<MacroNode>& noeuds);
+
+// Cellules triées par ligne puis colonne ; le coin de la boîte englobante
+// devient l'origine du fichier
+bool write_rle(const string& chemin, const vector<pair<int64_t, int64_t>>& cellules);
@@ -0,0 +1,42 @@
+#pragma once
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+class ThreadPool {
+
+    private:
+
+        std::vector<std::thread> threads;
+
+        std::mutex mutex;
+        std::condition_variable travail_pret;
+        std::condition_variable travail_fini;
+
+        std::function<void(size_t, size_t, unsigned)> tache;
+        std::atomic<size_t> prochain;
+        size_t nb_elements, taille_bloc;
+
+        unsigned actifs;
+        unsigned long generation;
+        bool arret;
+
+        void boucle(unsigned id);
+
+        void executer(unsigned id);
+
+    public:
+
+        ThreadPool(unsigned nb_threads);
+
+        ~ThreadPool();
+
+        unsigned size() const;
+
+        // Découpe [0, n) en blocs de taille (au moins 1) ; f(debut, fin, id) avec id < size()
+        void parallel_for(size_t n, size_t taille, std::function<void(size_t, size_t, unsigned)> f);
+
+};
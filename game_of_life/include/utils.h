@@ -1,10 +1,26 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstddef>
+
 //Grid
 constexpr int NB_LIGNES = 150;
 constexpr int NB_COLONNES = 200;
 constexpr int TAILLE_CELLULE = 5;
+constexpr int TAILLE_TUILE = 64;
+// Lignes par tâche du moteur dense : un plateau de 150 lignes n'a que
+// 3 rangées de tuiles, mais 10 tranches à répartir entre les threads
+constexpr int LIGNES_TACHE = 16;
+static_assert(TAILLE_TUILE % LIGNES_TACHE == 0, "une tranche ne chevauche pas deux tuiles");
+
+//HashLife
+// Limite vérifiée pendant chaque pas, à un bloc de nœuds près (2,5 Mo)
+constexpr size_t HASHLIFE_MEMOIRE = size_t(256) << 20;
+constexpr int EXPOSANT_MAX = 32;
+
+//Motifs
+constexpr const char* SAUVEGARDE_RLE = "sauvegarde.rle";
+constexpr const char* SAUVEGARDE_MC = "sauvegarde.mc";
 
 //Fenêtre
 constexpr int LARGEUR = NB_COLONNES * TAILLE_CELLULE;
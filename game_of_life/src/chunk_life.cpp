@@ -0,0 +1,248 @@
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "utils.h"
+#include "bitboard.h"
+#include "chunk_life.h"
+
+uint64_t ChunkLife::cle(int64_t cx, int64_t cy) {
+
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cy)) << 32) | static_cast<uint32_t>(cx);
+
+}
+
+ChunkLife::Chunk* ChunkLife::trouver(int64_t cx, int64_t cy) {
+
+    auto it = chunks.find(cle(cx, cy));
+    return it == chunks.end() ? nullptr : &it->second;
+
+}
+
+const ChunkLife::Chunk* ChunkLife::trouver(int64_t cx, int64_t cy) const {
+
+    auto it = chunks.find(cle(cx, cy));
+    return it == chunks.end() ? nullptr : &it->second;
+
+}
+
+ChunkLife::Chunk& ChunkLife::obtenir(int64_t cx, int64_t cy) {
+
+    auto [it, nouveau] = chunks.try_emplace(cle(cx, cy));
+
+    if (nouveau) {
+
+        Chunk& chunk = it->second;
+
+        chunk.cx = cx;
+        chunk.cy = cy;
+        std::memset(chunk.lignes, 0, sizeof(chunk.lignes));
+        chunk.modifie = false;
+
+    }
+
+    return it->second;
+
+}
+
+void ChunkLife::clear() {
+
+    chunks.clear();
+
+}
+
+bool ChunkLife::get_cell(int64_t row, int64_t col) const {
+
+    const Chunk* chunk = trouver(col >> 6, row >> 6);
+    if (!chunk) return false;
+
+    return (chunk->lignes[row & 63] >> (col & 63)) & 1;
+
+}
+
+void ChunkLife::set_cell(int64_t row, int64_t col, bool state) {
+
+    if (!state && !trouver(col >> 6, row >> 6)) return;
+
+    Chunk& chunk = obtenir(col >> 6, row >> 6);
+    uint64_t bit = uint64_t(1) << (col & 63);
+
+    if (state) chunk.lignes[row & 63] |= bit;
+    else chunk.lignes[row & 63] &= ~bit;
+
+    chunk.modifie = true;
+
+}
+
+void ChunkLife::insert_block(int64_t cy, int64_t cx, const uint64_t* lignes) {
+
+    Chunk& chunk = obtenir(cx, cy);
+
+    for (int r = 0; r < COTE; r ++) chunk.lignes[r] |= lignes[r];
+    chunk.modifie = true;
+
+}
+
+void ChunkLife::step() {
+
+    // Un morceau qui vient de changer et touche un bord peut faire naître
+    // des cellules chez son voisin : on crée ce voisin avant de calculer.
+    // Un morceau stable ne fait rien naître de nouveau à côté de lui.
+    vector<pair<int64_t, int64_t>> a_creer;
+
+    for (const auto& [cle_chunk, chunk] : chunks) {
+
+        if (!chunk.modifie) continue;
+
+        uint64_t gauche = 0, droite = 0;
+
+        for (uint64_t ligne : chunk.lignes) {
+
+            gauche |= ligne & 1;
+            droite |= ligne >> 63;
+
+        }
+
+        bool haut = chunk.lignes[0] != 0, bas = chunk.lignes[COTE - 1] != 0;
+
+        for (int dy = -1; dy <= 1; dy ++) {
+            for (int dx = -1; dx <= 1; dx ++) {
+
+                bool touche_x = dx == 0 || (dx < 0 ? gauche : droite);
+                bool touche_y = dy == 0 || (dy < 0 ? haut : bas);
+
+                if ((dx || dy) && touche_x && touche_y) a_creer.push_back({chunk.cx + dx, chunk.cy + dy});
+
+            }
+
+        }
+
+    }
+
+    for (auto [cx, cy] : a_creer) obtenir(cx, cy);
+
+    // Les pointeurs vers les éléments restent valides tant qu'on n'insère
+    // ni ne supprime rien
+    vector<Chunk*> calcules;
+    uint64_t bloc[COTE + 2][3];
+
+    for (auto& [cle_chunk, chunk] : chunks) {
+
+        Chunk* voisins[3][3];
+        bool actif = false;
+
+        for (int dy = -1; dy <= 1; dy ++) {
+            for (int dx = -1; dx <= 1; dx ++) {
+
+                Chunk* voisin = dx || dy ? trouver(chunk.cx + dx, chunk.cy + dy) : &chunk;
+
+                voisins[dy + 1][dx + 1] = voisin;
+                if (voisin && voisin->modifie) actif = true;
+
+            }
+
+        }
+
+        if (!actif) continue;
+
+        // Lignes 0 et COTE + 1 : bords des morceaux du dessus et du dessous
+        for (int dx = 0; dx < 3; dx ++) {
+
+            bloc[0][dx] = voisins[0][dx] ? voisins[0][dx]->lignes[COTE - 1] : 0;
+            bloc[COTE + 1][dx] = voisins[2][dx] ? voisins[2][dx]->lignes[0] : 0;
+
+            for (int r = 0; r < COTE; r ++) {
+
+                bloc[r + 1][dx] = voisins[1][dx] ? voisins[1][dx]->lignes[r] : 0;
+
+            }
+
+        }
+
+        for (int r = 0; r < COTE; r ++) {
+
+            chunk.suivant[r] = generation(bloc[r], bloc[r + 1], bloc[r + 2], 1, 3);
+
+        }
+
+        calcules.push_back(&chunk);
+
+    }
+
+    for (auto& [cle_chunk, chunk] : chunks) chunk.modifie = false;
+
+    for (Chunk* chunk : calcules) {
+
+        chunk->modifie = std::memcmp(chunk->lignes, chunk->suivant, sizeof(chunk->lignes)) != 0;
+        std::memcpy(chunk->lignes, chunk->suivant, sizeof(chunk->lignes));
+
+    }
+
+    // Un morceau qui vient de se vider reste une génération de plus pour que
+    // ses voisins voient le changement
+    for (auto it = chunks.begin(); it != chunks.end(); ) {
+
+        const Chunk& chunk = it->second;
+        bool vide = !chunk.modifie;
+
+        for (int r = 0; r < COTE && vide; r ++) vide = chunk.lignes[r] == 0;
+
+        if (vide) it = chunks.erase(it);
+        else ++it;
+
+    }
+
+}
+
+uint64_t ChunkLife::population() const {
+
+    uint64_t total = 0;
+
+    for (const auto& [cle_chunk, chunk] : chunks) {
+
+        for (uint64_t ligne : chunk.lignes) total += __builtin_popcountll(ligne);
+
+    }
+
+    return total;
+
+}
+
+size_t ChunkLife::chunk_count() const {
+
+    return chunks.size();
+
+}
+
+size_t ChunkLife::memory() const {
+
+    return chunks.size() * (sizeof(Chunk) + sizeof(uint64_t) + 2 * sizeof(void*)) + chunks.bucket_count() * sizeof(void*);
+
+}
+
+void ChunkLife::cells(int64_t r0, int64_t c0, int64_t r1, int64_t c1, vector<pair<int64_t, int64_t>>& sortie) const {
+
+    sortie.clear();
+
+    for (const auto& [cle_chunk, chunk] : chunks) {
+
+        int64_t y = chunk.cy * COTE, x = chunk.cx * COTE;
+        if (x >= c1 || y >= r1 || x + COTE <= c0 || y + COTE <= r0) continue;
+
+        for (int r = 0; r < COTE; r ++) {
+
+            if (y + r < r0 || y + r >= r1) continue;
+
+            for (uint64_t mot = chunk.lignes[r]; mot; mot &= mot - 1) {
+
+                int64_t c = x + __builtin_ctzll(mot);
+                if (c0 <= c && c < c1) sortie.push_back({y + r, c});
+
+            }
+
+        }
+
+    }
+
+}
@@ -9,6 +9,20 @@ Game::Game() : window(sf::VideoMode({LARGEUR, HAUTEUR}), "Game of Life"), FPS(60
 
 }
 
+bool Game::load_pattern(const string& chemin) {
+
+    // Un macrocell peut dépasser de loin le plateau : HashLife directement
+    if (chemin.size() >= 3 && chemin.compare(chemin.size() - 3, 3, ".mc") == 0) {
+
+        grid.set_engine(Moteur::HASHLIFE);
+        return grid.insert_pattern(chemin, 0, 0);
+
+    }
+
+    return grid.insert_pattern(chemin, NB_LIGNES / 3, NB_COLONNES / 3);
+
+}
+
 void Game::handle_events() {
     
     while (auto event = window.pollEvent()) {
@@ -27,6 +41,36 @@ void Game::handle_events() {
 
             } 
 
+            if (keyPressed->code == sf::Keyboard::Key::H) {
+
+                // Dense -> HashLife -> infini -> dense
+                Moteur moteur = grid.get_engine();
+
+                if (moteur == Moteur::DENSE) grid.set_engine(Moteur::HASHLIFE);
+                else if (moteur == Moteur::HASHLIFE) grid.set_engine(Moteur::INFINI);
+                else grid.set_engine(Moteur::DENSE);
+
+            } 
+
+            if (keyPressed->code == sf::Keyboard::Key::W) {
+
+                grid.save_pattern(grid.get_engine() == Moteur::HASHLIFE ? SAUVEGARDE_MC : SAUVEGARDE_RLE);
+
+            } 
+
+            // Pas de HashLife : 2^exposant générations par frame
+            if (keyPressed->code == sf::Keyboard::Key::Up) {
+
+                grid.set_step(grid.get_step() + 1);
+
+            } 
+
+            if (keyPressed->code == sf::Keyboard::Key::Down) {
+
+                grid.set_step(grid.get_step() - 1);
+
+            } 
+
             if (keyPressed->code == sf::Keyboard::Key::Right) {
 
                 FPS += 2;
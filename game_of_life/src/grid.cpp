@@ -1,69 +1,339 @@
-#include <tuple>
+#include <algorithm>
 #include <vector>
+#include <climits>
+#include <cstdint>
 
 #include "grid.h"
 #include "utils.h"
+#include "bitboard.h"
+#include "hashlife.h"
+#include "chunk_life.h"
+#include "pattern.h"
 #include <SFML/Graphics.hpp>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GRID_X86 1
+#include <immintrin.h>
+#else
+#define GRID_X86 0
+#endif
+
 using namespace sf;
 
-Grid::Grid() {
+static inline const uint64_t* ligne(const uint64_t* cels, const uint64_t* vide, int r, int row, int mots) {
 
-    row = NB_LIGNES;
-    col = NB_COLONNES;
+    return r < 0 || r >= row ? vide : cels + r * mots;
 
-    nb_generation = 0;
+}
+
+static void bande_scalaire(const uint64_t* cels, uint64_t* suivant, uint64_t* difference, const uint64_t* vide, int r0, int r1, int row, int debut, int fin, int mots) {
+
+    for (int w = debut; w < fin; w ++) {
+
+        uint64_t change = 0;
+
+        for (int r = r0; r < r1; r ++) {
+
+            const uint64_t* milieu = cels + r * mots;
+            uint64_t vivant = generation(ligne(cels, vide, r - 1, row, mots), milieu, ligne(cels, vide, r + 1, row, mots), w, mots);
+
+            suivant[r * mots + w] = vivant;
+            change |= vivant ^ milieu[w];
+
+        }
+
+        difference[w] |= change;
+
+    }
+
+}
+
+#if GRID_X86
+
+// Mots w - 1 .. w + 2 et w + 1 .. w + 4, zéro hors de la ligne
+__attribute__((target("avx2")))
+static inline __m256i mots_precedents(const uint64_t* ligne, int w) {
+
+    if (w > 0) return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ligne + w - 1));
+    return _mm256_set_epi64x(ligne[2], ligne[1], ligne[0], 0);
+
+}
+
+__attribute__((target("avx2")))
+static inline __m256i mots_suivants(const uint64_t* ligne, int w, int mots) {
+
+    if (w + 4 < mots) return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ligne + w + 1));
+    return _mm256_set_epi64x(0, ligne[w + 3], ligne[w + 2], ligne[w + 1]);
+
+}
+
+__attribute__((target("avx2")))
+static inline __m256i ouest(__m256i mot, __m256i precedent) {
+
+    return _mm256_or_si256(_mm256_slli_epi64(mot, 1), _mm256_srli_epi64(precedent, 63));
+
+}
+
+__attribute__((target("avx2")))
+static inline __m256i est(__m256i mot, __m256i suivant) {
+
+    return _mm256_or_si256(_mm256_srli_epi64(mot, 1), _mm256_slli_epi64(suivant, 63));
+
+}
+
+__attribute__((target("avx2")))
+static inline void additionne(__m256i a, __m256i b, __m256i c, __m256i& somme, __m256i& retenue) {
+
+    __m256i ab = _mm256_xor_si256(a, b);
+
+    somme = _mm256_xor_si256(ab, c);
+    retenue = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, ab));
+
+}
+
+// Voisins d'une ligne pour 256 cellules : somme des deux voisins ouest / est
+// (ligne du milieu) et des trois cellules (lignes du haut et du bas)
+struct Somme {
+
+    __m256i centre, deux0, deux1, trois0, trois1;
+
+};
+
+__attribute__((target("avx2")))
+static inline Somme sommer(const uint64_t* ligne, int w, int mots) {
+
+    Somme s;
+
+    s.centre = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ligne + w));
+
+    __m256i o = ouest(s.centre, mots_precedents(ligne, w));
+    __m256i e = est(s.centre, mots_suivants(ligne, w, mots));
+
+    s.deux0 = _mm256_xor_si256(o, e);
+    s.deux1 = _mm256_and_si256(o, e);
+    s.trois0 = _mm256_xor_si256(s.deux0, s.centre);
+    s.trois1 = _mm256_or_si256(s.deux1, _mm256_and_si256(s.deux0, s.centre));
+
+    return s;
+
+}
+
+// Même logique que generation, 256 cellules par itération ; on descend
+// colonne par colonne pour que chaque ligne ne soit sommée qu'une fois et
+// que les changements restent dans un registre
+__attribute__((target("avx2")))
+static void bande_avx2(const uint64_t* cels, uint64_t* suivant, uint64_t* difference, const uint64_t* vide, int r0, int r1, int row, int debut, int fin, int mots) {
+
+    int w = debut;
+
+    for (; w + 4 <= fin; w += 4) {
+
+        Somme haut = sommer(ligne(cels, vide, r0 - 1, row, mots), w, mots);
+        Somme milieu = sommer(ligne(cels, vide, r0, row, mots), w, mots);
+        __m256i change = _mm256_setzero_si256();
+
+        for (int r = r0; r < r1; r ++) {
+
+            Somme bas = sommer(ligne(cels, vide, r + 1, row, mots), w, mots);
+
+            __m256i s0, c0, d0, d1;
+            additionne(haut.trois0, milieu.deux0, bas.trois0, s0, c0);
+            additionne(haut.trois1, milieu.deux1, bas.trois1, d0, d1);
+
+            __m256i s1 = _mm256_xor_si256(d0, c0);
+            __m256i s2 = _mm256_xor_si256(d1, _mm256_and_si256(d0, c0));
+
+            __m256i vivant = _mm256_andnot_si256(s2, _mm256_and_si256(s1, _mm256_or_si256(s0, milieu.centre)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(suivant + r * mots + w), vivant);
+
+            change = _mm256_or_si256(change, _mm256_xor_si256(vivant, milieu.centre));
+
+            haut = milieu;
+            milieu = bas;
+
+        }
+
+        __m256i* cumul = reinterpret_cast<__m256i*>(difference + w);
+        _mm256_storeu_si256(cumul, _mm256_or_si256(_mm256_loadu_si256(cumul), change));
+
+    }
+
+    bande_scalaire(cels, suivant, difference, vide, r0, r1, row, w, fin, mots);
+
+}
+
+#endif
+
+static BandKernel choisir_noyau() {
+
+#if GRID_X86
+    if (__builtin_cpu_supports("avx2")) return bande_avx2;
+#endif
+    return bande_scalaire;
+
+}
+
+static const BandKernel noyau_defaut = choisir_noyau();
+
+const char* update_path() {
+
+#if GRID_X86
+    if (noyau_defaut == bande_avx2) return "avx2";
+#endif
+    return "scalar";
+
+}
+
+vector<pair<const char*, BandKernel>> update_kernels() {
+
+    vector<pair<const char*, BandKernel>> noyaux = {{"scalar", bande_scalaire}};
+
+#if GRID_X86
+    if (__builtin_cpu_supports("avx2")) noyaux.push_back({"avx2", bande_avx2});
+#endif
+
+    return noyaux;
+
+}
+
+Grid::Grid() : Grid(NB_LIGNES, NB_COLONNES) {}
+
+Grid::Grid(int row, int col, unsigned nb_threads) : row(row), col(col), nb_generation(0), moteur(Moteur::DENSE), noyau(noyau_defaut), exposant(0), threads(nb_threads) {
+
+    dernier = (col - 1) / 64;
+    mots = (dernier + 4) & ~3;
+    masque_fin = col % 64 ? (uint64_t(1) << (col % 64)) - 1 : ~uint64_t(0);
+
+    cels.assign(row * mots, 0);
+    suivant.assign(row * mots, 0);
+
+    tuiles_x = dernier + 1;
+    tuiles_y = (row + TAILLE_TUILE - 1) / TAILLE_TUILE;
+
+    modifiees.assign(tuiles_x * tuiles_y, 0);
+    a_calculer.assign(tuiles_x * tuiles_y, 0);
+    nb_actives = nb_sautees = 0;
+
+    vide.assign(mots, 0);
+    tranches = (row + LIGNES_TACHE - 1) / LIGNES_TACHE;
+    changements.assign(tranches * tuiles_x, 0);
+    plages.resize(threads.size());
+
+}
+
+void Grid::mark_tile(int row, int col) {
+
+    modifiees[(row / TAILLE_TUILE) * tuiles_x + col / 64] = 1;
+
+}
+
+void Grid::live_cells(vector<pair<int64_t, int64_t>>& sortie) {
+
+    sortie.clear();
+
+    if (moteur == Moteur::DENSE) {
+
+        for (int r = 0; r < row; r ++) {
+            for (int w = 0; w < mots; w ++) {
+
+                for (uint64_t mot = cels[r * mots + w]; mot; mot &= mot - 1) {
+
+                    sortie.push_back({r, 64 * w + __builtin_ctzll(mot)});
+
+                }
+
+            }
+
+        }
+
+        return;
+
+    }
+
+    if (moteur == Moteur::HASHLIFE) hashlife.cells(INT64_MIN, INT64_MIN, INT64_MAX, INT64_MAX, sortie);
+    else plan.cells(INT64_MIN, INT64_MIN, INT64_MAX, INT64_MAX, sortie);
+
+    std::sort(sortie.begin(), sortie.end());
 
 }
 
 set<pair<int, int>> Grid::get_cels() {
 
-    return cels;
+    vector<pair<int64_t, int64_t>> vivantes;
+    live_cells(vivantes);
+
+    set<pair<int, int>> resultat;
+    for (auto [r, c] : vivantes) resultat.insert(resultat.end(), {r, c});
+
+    return resultat;
 
 }
 
 bool Grid::get_cell(int row, int col) {
 
-    return cels.count({row, col}) > 0;
+    if (moteur == Moteur::HASHLIFE) return hashlife.get_cell(row, col);
+    if (moteur == Moteur::INFINI) return plan.get_cell(row, col);
+
+    if (row < 0 || row >= this->row || col < 0 || col >= this->col) return false;
+
+    return (cels[row * mots + col / 64] >> (col % 64)) & 1;
 
 }
 
 void Grid::set_cell(int row, int col, bool state) {
 
-    if (cels.count({row, col}) && state == false) {
+    if (moteur == Moteur::HASHLIFE) {
 
-        cels.erase({row, col});
+        hashlife.set_cell(row, col, state);
+        return;
 
     }
 
-    if (!cels.count({row, col}) && state == true) {
+    if (moteur == Moteur::INFINI) {
 
-        cels.insert({row, col});
+        plan.set_cell(row, col, state);
+        return;
 
     }
 
+    if (row < 0 || row >= this->row || col < 0 || col >= this->col) return;
+
+    mark_tile(row, col);
+
+    uint64_t bit = uint64_t(1) << (col % 64);
+    uint64_t& mot = cels[row * mots + col / 64];
+
+    if (state) mot |= bit;
+    else mot &= ~bit;
+
 }
 
 void Grid::toggle_cell(int row, int col) {
 
-    if (cels.count({row, col})) {
+    if (moteur == Moteur::HASHLIFE) {
 
-        cels.erase({row, col});
+        hashlife.set_cell(row, col, !hashlife.get_cell(row, col));
+        return;
 
     }
 
-    else {
+    if (moteur == Moteur::INFINI) {
 
-        cels.insert({row, col});
+        plan.set_cell(row, col, !plan.get_cell(row, col));
+        return;
 
     }
 
+    if (row < 0 || row >= this->row || col < 0 || col >= this->col) return;
+
+    mark_tile(row, col);
+    cels[row * mots + col / 64] ^= uint64_t(1) << (col % 64);
+
 }
 
 int Grid::count_voisins(int row, int col) {
 
-    int nb_voisins = 0;
-    std::vector<std::tuple<int, int>> direction = {
+    static const int direction[8][2] = {
         {-1, 0},
         {0, -1},
         {1, 0},
@@ -74,12 +344,11 @@ int Grid::count_voisins(int row, int col) {
         {1, -1},
     };
 
-    for (auto &[x, y] : direction) {
+    int nb_voisins = 0;
 
-        int r = row + x;
-        int c = col + y;
+    for (auto &[x, y] : direction) {
 
-        if (0 <= r && r < this->row && 0 <= c && c < this->col && cels.count({r, c})) {
+        if (get_cell(row + x, col + y)) {
 
             nb_voisins += 1;
 
@@ -131,52 +400,171 @@ bool Grid::apply_rules(int row, int col, int nb_voisins) {
 
 int Grid::get_len_cels() {
 
-    return cels.size();
+    if (moteur == Moteur::HASHLIFE) return std::min<uint64_t>(hashlife.population(), INT_MAX);
+    if (moteur == Moteur::INFINI) return std::min<uint64_t>(plan.population(), INT_MAX);
+
+    int total = 0;
+
+    for (uint64_t mot : cels) {
+
+        total += __builtin_popcountll(mot);
+
+    }
+
+    return total;
 
 }
 
 void Grid::clear() {
 
     nb_generation = 0;
-    cels.clear();
+    std::fill(cels.begin(), cels.end(), 0);
+    std::fill(suivant.begin(), suivant.end(), 0);
+    std::fill(modifiees.begin(), modifiees.end(), 0);
+    hashlife.clear();
+    plan.clear();
 
 }
 
 void Grid::update() {
 
-    set<pair<int, int>> new_cels;
+    if (moteur == Moteur::HASHLIFE) {
+
+        hashlife.step(exposant);
+        nb_generation += uint64_t(1) << exposant;
+        return;
+
+    }
+
+    if (moteur == Moteur::INFINI) {
+
+        plan.step();
+        nb_generation += 1;
+        return;
+
+    }
+
+    // Tuiles à recalculer : celles qui ont changé et leurs huit voisines
+    std::fill(a_calculer.begin(), a_calculer.end(), 0);
+
+    for (int ty = 0; ty < tuiles_y; ty ++) {
+        for (int tx = 0; tx < tuiles_x; tx ++) {
+
+            if (!modifiees[ty * tuiles_x + tx]) continue;
+
+            for (int y = std::max(ty - 1, 0); y <= std::min(ty + 1, tuiles_y - 1); y ++) {
+                for (int x = std::max(tx - 1, 0); x <= std::min(tx + 1, tuiles_x - 1); x ++) {
+
+                    a_calculer[y * tuiles_x + x] = 1;
+
+                }
+
+            }
+
+        }
+
+    }
+
+    nb_actives = std::count(a_calculer.begin(), a_calculer.end(), 1);
+    nb_sautees = a_calculer.size() - nb_actives;
 
-    for (int x = 0; x <= row; x ++) {
-        for (int y = 0; y <= col; y ++){
+    // Une tranche de lignes par tâche : le résultat ne dépend pas du découpage
+    threads.parallel_for(tranches, 1, [this](size_t debut, size_t fin, unsigned id) {
 
-            int nb_voisin = count_voisins(x, y);
+        for (int t = debut; t < static_cast<int>(fin); t ++) {
 
-            if (apply_rules(x, y, nb_voisin)) {
+            int r0 = t * LIGNES_TACHE, r1 = std::min(row, r0 + LIGNES_TACHE);
+            int ty = r0 / TAILLE_TUILE;
 
-                new_cels.insert({x, y});
+            // Mots contigus à recalculer dans cette rangée de tuiles, traités
+            // d'un seul appel pour garder le noyau vectoriel
+            const uint8_t* rangee = &a_calculer[ty * tuiles_x];
+            vector<pair<int, int>>& runs = plages[id];
+            runs.clear();
+
+            for (int tx = 0; tx < tuiles_x; tx ++) {
+
+                if (!rangee[tx]) continue;
+
+                int gauche = tx;
+                while (tx < tuiles_x && rangee[tx]) tx ++;
+                runs.push_back({gauche, tx});
+
+            }
+
+            uint64_t* difference = &changements[t * tuiles_x];
+            std::fill(difference, difference + tuiles_x, 0);
+
+            for (auto [gauche, droite] : runs) {
+
+                noyau(cels.data(), suivant.data(), difference, vide.data(), r0, r1, row, gauche, droite, mots);
+
+                // Les naissances au-delà de col sont hors du plateau
+                if (droite == tuiles_x) {
+
+                    for (int r = r0; r < r1; r ++) suivant[r * mots + dernier] &= masque_fin;
+
+                }
 
             }
 
+            // Ces mêmes bits ne comptent pas comme un changement
+            difference[dernier] &= masque_fin;
+
         }
 
+    });
+
+    // Une tuile a changé si l'une de ses tranches a changé
+    std::fill(modifiees.begin(), modifiees.end(), 0);
+
+    for (int t = 0; t < tranches; t ++) {
+
+        uint8_t* rangee = &modifiees[(t * LIGNES_TACHE / TAILLE_TUILE) * tuiles_x];
+        const uint64_t* difference = &changements[t * tuiles_x];
+
+        for (int tx = 0; tx < tuiles_x; tx ++) rangee[tx] |= difference[tx] != 0;
+
     }
 
-    cels = new_cels;
+    cels.swap(suivant);
     nb_generation += 1;
 
 }
 
 void Grid::draw(sf::RenderWindow& window) {
 
-    for (int r = 0; r < NB_LIGNES; r ++) {
-        for (int c = 0; c < NB_COLONNES; c ++) {
+    sf::RectangleShape cel(sf::Vector2f(TAILLE_CELLULE, TAILLE_CELLULE));
+
+    if (moteur != Moteur::DENSE) {
+
+        static vector<pair<int64_t, int64_t>> visibles;
+
+        if (moteur == Moteur::HASHLIFE) hashlife.cells(0, 0, NB_LIGNES, NB_COLONNES, visibles);
+        else plan.cells(0, 0, NB_LIGNES, NB_COLONNES, visibles);
 
-            if (get_cell(r, c)) {
+        for (auto [r, c] : visibles) {
+
+            cel.setPosition(sf::Vector2f(static_cast<float>(c * TAILLE_CELLULE), static_cast<float>(r * TAILLE_CELLULE)));
+            window.draw(cel);
+
+        }
+
+        return;
+
+    }
+
+    for (int r = 0; r < std::min(row, NB_LIGNES); r ++) {
+        for (int w = 0; w < mots; w ++) {
+
+            for (uint64_t mot = cels[r * mots + w]; mot; mot &= mot - 1) {
+
+                int c = 64 * w + __builtin_ctzll(mot);
+                if (c >= NB_COLONNES) break;
 
                 float pixel_x = c * TAILLE_CELLULE;
                 float pixel_y = r * TAILLE_CELLULE;
 
-                sf::RectangleShape cel(sf::Vector2f(TAILLE_CELLULE, TAILLE_CELLULE));
                 cel.setPosition(sf::Vector2f(static_cast<float>(pixel_x), static_cast<float>(pixel_y)));
 
                 window.draw(cel);
@@ -187,4 +575,239 @@ void Grid::draw(sf::RenderWindow& window) {
 
     }
 
+}
+
+void Grid::set_engine(Moteur moteur) {
+
+    if (moteur == this->moteur) return;
+
+    // Le plateau dense ne reçoit que ce qui tient dedans
+    vector<pair<int64_t, int64_t>> vivantes;
+    live_cells(vivantes);
+
+    uint64_t generations = nb_generation;
+    clear();
+    nb_generation = generations;
+
+    this->moteur = moteur;
+
+    if (moteur == Moteur::DENSE) std::fill(modifiees.begin(), modifiees.end(), 1);
+
+    for (auto [r, c] : vivantes) set_cell(r, c, true);
+
+}
+
+Moteur Grid::get_engine() const {
+
+    return moteur;
+
+}
+
+void Grid::set_step(int exposant) {
+
+    this->exposant = std::max(0, std::min(exposant, EXPOSANT_MAX));
+
+}
+
+int Grid::get_step() const {
+
+    return exposant;
+
+}
+
+uint64_t Grid::get_generation() const {
+
+    return nb_generation;
+
+}
+
+size_t Grid::get_active_tiles() const {
+
+    return nb_actives;
+
+}
+
+size_t Grid::get_skipped_tiles() const {
+
+    return nb_sautees;
+
+}
+
+void Grid::set_kernel(BandKernel noyau) {
+
+    this->noyau = noyau;
+
+}
+
+void Grid::insert_block(int64_t by, int64_t bx, const uint64_t* lignes) {
+
+    if (moteur == Moteur::HASHLIFE) {
+
+        hashlife.insert(hashlife.block(lignes), 64 * by, 64 * bx);
+        return;
+
+    }
+
+    if (moteur == Moteur::INFINI) {
+
+        plan.insert_block(by, bx, lignes);
+        return;
+
+    }
+
+    // Les blocs sont alignés sur les mots du plateau
+    if (bx < 0 || bx > dernier) return;
+
+    for (int r = 0; r < 64; r ++) {
+
+        int64_t y = 64 * by + r;
+        if (y < 0 || y >= row || !lignes[r]) continue;
+
+        cels[y * mots + bx] |= bx == dernier ? lignes[r] & masque_fin : lignes[r];
+        mark_tile(y, 64 * bx);
+
+    }
+
+}
+
+// Macrocell vers un moteur plat : parcours de l'arbre, feuilles posées
+// cellule par cellule, en coordonnées 64 bits, dans [r0, r1) x [c0, c1)
+using CellSink = function<void(int64_t row, int64_t col)>;
+
+static void poser(const CellSink& cellule, const vector<MacroNode>& noeuds, uint32_t i, int niveau, int64_t y, int64_t x,
+                  int64_t r0, int64_t c0, int64_t r1, int64_t c1) {
+
+    if (i == 0) return;
+
+    int64_t taille = int64_t(1) << niveau;
+    if (y >= r1 || x >= c1 || y + taille <= r0 || x + taille <= c0) return;
+
+    const MacroNode& noeud = noeuds[i];
+
+    if (niveau == 3) {
+
+        for (uint64_t bits = noeud.feuille; bits; bits &= bits - 1) {
+
+            int k = __builtin_ctzll(bits);
+            int64_t r = y + k / 8, c = x + k % 8;
+
+            // Une feuille peut déborder de la boîte
+            if (r >= r0 && r < r1 && c >= c0 && c < c1) cellule(r, c);
+
+        }
+
+        return;
+
+    }
+
+    int64_t moitie = taille / 2;
+
+    poser(cellule, noeuds, noeud.enfants[0], niveau - 1, y, x, r0, c0, r1, c1);
+    poser(cellule, noeuds, noeud.enfants[1], niveau - 1, y, x + moitie, r0, c0, r1, c1);
+    poser(cellule, noeuds, noeud.enfants[2], niveau - 1, y + moitie, x, r0, c0, r1, c1);
+    poser(cellule, noeuds, noeud.enfants[3], niveau - 1, y + moitie, x + moitie, r0, c0, r1, c1);
+
+}
+
+static bool macrocell(const string& chemin) {
+
+    return chemin.size() >= 3 && chemin.compare(chemin.size() - 3, 3, ".mc") == 0;
+
+}
+
+bool Grid::insert_pattern(const string& chemin, int row, int col) {
+
+    MappedFile fichier;
+    if (!fichier.open(chemin)) return false;
+
+    if (!macrocell(chemin)) {
+
+        return read_rle(fichier, row, col, [this](int64_t by, int64_t bx, const uint64_t* lignes) {
+            insert_block(by, bx, lignes);
+        });
+
+    }
+
+    vector<MacroNode> noeuds;
+    if (!read_macrocell(fichier, noeuds)) return false;
+
+    // Comme à l'écriture, la racine est centrée sur l'origine, placée en (row, col)
+    int64_t moitie = int64_t(1) << (noeuds.back().niveau - 1);
+
+    if (moteur == Moteur::HASHLIFE) {
+
+        // Chaque ligne devient un nœud partagé, sans passer par les cellules
+        vector<uint32_t> ids(noeuds.size());
+
+        for (size_t i = 1; i < noeuds.size(); i ++) {
+
+            const MacroNode& noeud = noeuds[i];
+
+            if (noeud.niveau == 3) {
+
+                ids[i] = hashlife.leaf(noeud.feuille);
+                continue;
+
+            }
+
+            uint32_t enfants[4];
+
+            for (int k = 0; k < 4; k ++) {
+
+                enfants[k] = noeud.enfants[k] ? ids[noeud.enfants[k]] : hashlife.empty(noeud.niveau - 1);
+
+            }
+
+            ids[i] = hashlife.join(enfants[0], enfants[1], enfants[2], enfants[3]);
+
+        }
+
+        hashlife.insert(ids.back(), row - moitie, col - moitie);
+        return true;
+
+    }
+
+    uint32_t racine = noeuds.size() - 1;
+    int niveau = noeuds.back().niveau;
+
+    // Plan infini : écriture directe en 64 bits, dans la zone que ses clés
+    // savent adresser ; les cellules au-delà sont ignorées
+    if (moteur == Moteur::INFINI) {
+
+        poser([this](int64_t r, int64_t c) { plan.set_cell(r, c, true); }, noeuds, racine, niveau, row - moitie, col - moitie,
+              -ChunkLife::LIMITE, -ChunkLife::LIMITE, ChunkLife::LIMITE, ChunkLife::LIMITE);
+
+        return true;
+
+    }
+
+    // Dense : rogné au plateau, les coordonnées tiennent donc dans un int
+    poser([this](int64_t r, int64_t c) { set_cell(static_cast<int>(r), static_cast<int>(c), true); }, noeuds, racine, niveau,
+          row - moitie, col - moitie, 0, 0, this->row, this->col);
+
+    return true;
+
+}
+
+bool Grid::save_pattern(const string& chemin) {
+
+    if (macrocell(chemin)) {
+
+        if (moteur == Moteur::HASHLIFE) return hashlife.save_macrocell(chemin);
+
+        HashLife copie;
+        vector<pair<int64_t, int64_t>> vivantes;
+        live_cells(vivantes);
+
+        for (auto [r, c] : vivantes) copie.set_cell(r, c, true);
+
+        return copie.save_macrocell(chemin);
+
+    }
+
+    vector<pair<int64_t, int64_t>> vivantes;
+    live_cells(vivantes);
+
+    return write_rle(chemin, vivantes);
+
 }
\ No newline at end of file
@@ -0,0 +1,744 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+#include "utils.h"
+#include "hashlife.h"
+
+static inline size_t hacher(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+
+    uint64_t h = nw;
+    h = h * 0x9E3779B97F4A7C15ull + ne;
+    h = h * 0x9E3779B97F4A7C15ull + sw;
+    h = h * 0x9E3779B97F4A7C15ull + se;
+
+    return h ^ (h >> 29);
+
+}
+
+HashLife::HashLife(size_t limite_octets) : borne(false), interrompu(false), limite_octets(limite_octets), nb_collectes(0) {
+
+    clear();
+
+}
+
+void HashLife::clear() {
+
+    // Les deux nœuds de niveau 0 : cellule morte et cellule vivante
+    noeuds.truncate(0);
+    noeuds.push_back(Noeud{AUCUN, AUCUN, AUCUN, AUCUN, AUCUN, AUCUN, 0, 0});
+    noeuds.push_back(Noeud{AUCUN, AUCUN, AUCUN, AUCUN, AUCUN, AUCUN, 1, 0});
+
+    vector<uint32_t>(1 << 16, AUCUN).swap(table);
+    vides.assign(1, 0);
+    feuilles.clear();
+    nb_vivants = 2;
+
+    exposant_memo = -1;
+    exposant_sur = EXPOSANT_MAX;
+    racine = vide(3);
+
+}
+
+uint32_t HashLife::creer(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+
+    size_t seau = hacher(nw, ne, sw, se) & (table.size() - 1);
+
+    for (uint32_t i = table[seau]; i != AUCUN; i = noeuds[i].chaine) {
+
+        const Noeud& n = noeuds[i];
+        if (n.nw == nw && n.ne == ne && n.sw == sw && n.se == se) return i;
+
+    }
+
+    Noeud nouveau{nw, ne, sw, se, AUCUN, table[seau],
+        noeuds[nw].population + noeuds[ne].population + noeuds[sw].population + noeuds[se].population,
+        noeuds[nw].niveau + 1};
+
+    // Nouveau bloc pendant un pas : le dernier moment pour respecter la limite
+    if (borne && noeuds.size() == noeuds.capacity() && memory() > limite_octets) interrompu = true;
+
+    // Le ramasse-miettes compacte le tableau : pas d'emplacement libre à réutiliser
+    uint32_t i = noeuds.size();
+    noeuds.push_back(nouveau);
+
+    table[seau] = i;
+    nb_vivants += 1;
+
+    if (nb_vivants > table.size()) rehash(table.size() * 2);
+
+    return i;
+
+}
+
+void HashLife::rehash(size_t taille) {
+
+    // Nouveau tableau plutôt que assign, pour rendre la mémoire quand la table rétrécit
+    vector<uint32_t>(taille, AUCUN).swap(table);
+
+    for (uint32_t i = 2; i < noeuds.size(); i ++) {
+
+        Noeud& n = noeuds[i];
+        size_t seau = hacher(n.nw, n.ne, n.sw, n.se) & (taille - 1);
+
+        n.chaine = table[seau];
+        table[seau] = i;
+
+    }
+
+}
+
+uint32_t HashLife::vide(int niveau) {
+
+    while (static_cast<int>(vides.size()) <= niveau) {
+
+        uint32_t v = vides.back();
+        vides.push_back(creer(v, v, v, v));
+
+    }
+
+    return vides[niveau];
+
+}
+
+uint32_t HashLife::centre(uint32_t n) {
+
+    Noeud c = noeuds[n];
+
+    return creer(noeuds[c.nw].se, noeuds[c.ne].sw, noeuds[c.sw].ne, noeuds[c.se].nw);
+
+}
+
+uint32_t HashLife::agrandir(uint32_t n) {
+
+    Noeud c = noeuds[n];
+    uint32_t e = vide(c.niveau - 1);
+
+    uint32_t nw = creer(e, e, e, c.nw);
+    uint32_t ne = creer(e, e, c.ne, e);
+    uint32_t sw = creer(e, c.sw, e, e);
+    uint32_t se = creer(c.se, e, e, e);
+
+    return creer(nw, ne, sw, se);
+
+}
+
+// Niveau 2 : centre 2x2 d'un bloc 4x4 après une génération, par force brute
+uint32_t HashLife::feuille(uint32_t n) {
+
+    bool bloc[4][4];
+    const Noeud& c = noeuds[n];
+    const uint32_t quarts[4] = {c.nw, c.ne, c.sw, c.se};
+
+    for (int q = 0; q < 4; q ++) {
+
+        const Noeud& quart = noeuds[quarts[q]];
+        int oy = (q / 2) * 2, ox = (q % 2) * 2;
+
+        bloc[oy][ox] = quart.nw == 1;
+        bloc[oy][ox + 1] = quart.ne == 1;
+        bloc[oy + 1][ox] = quart.sw == 1;
+        bloc[oy + 1][ox + 1] = quart.se == 1;
+
+    }
+
+    uint32_t resultat[2][2];
+
+    for (int y = 1; y <= 2; y ++) {
+        for (int x = 1; x <= 2; x ++) {
+
+            int nb_voisins = 0;
+
+            for (int dy = -1; dy <= 1; dy ++) {
+                for (int dx = -1; dx <= 1; dx ++) {
+
+                    if (dy || dx) nb_voisins += bloc[y + dy][x + dx];
+
+                }
+
+            }
+
+            resultat[y - 1][x - 1] = nb_voisins == 3 || (nb_voisins == 2 && bloc[y][x]);
+
+        }
+
+    }
+
+    return creer(resultat[0][0], resultat[0][1], resultat[1][0], resultat[1][1]);
+
+}
+
+// Centre de niveau k - 1 avancé de 2^min(j, k - 2) générations
+uint32_t HashLife::successeur(uint32_t n, int j) {
+
+    Noeud c = noeuds[n];
+
+    if (interrompu) return AUCUN;
+    if (c.population == 0) return vide(c.niveau - 1);
+    if (c.resultat != AUCUN) return c.resultat;
+
+    uint32_t r;
+
+    if (c.niveau == 2) {
+
+        r = feuille(n);
+
+    }
+
+    else {
+
+        Noeud nw = noeuds[c.nw], ne = noeuds[c.ne], sw = noeuds[c.sw], se = noeuds[c.se];
+
+        // Neuf sous-carrés de niveau k - 1 qui se chevauchent
+        uint32_t t[9] = {
+            c.nw,
+            creer(nw.ne, ne.nw, nw.se, ne.sw),
+            c.ne,
+            creer(nw.sw, nw.se, sw.nw, sw.ne),
+            creer(nw.se, ne.sw, sw.ne, se.nw),
+            creer(ne.sw, ne.se, se.nw, se.ne),
+            c.sw,
+            creer(sw.ne, se.nw, sw.se, se.sw),
+            c.se,
+        };
+
+        // Pleine vitesse : deux demi-pas ; sinon un seul pas depuis les centres
+        bool plein = j >= c.niveau - 2;
+
+        for (uint32_t& sous : t) {
+
+            sous = plein ? successeur(sous, j) : centre(sous);
+
+        }
+
+        // Interrompu : des sous-résultats manquent, rien n'est mémorisé ici
+        if (interrompu) return AUCUN;
+
+        uint32_t a = successeur(creer(t[0], t[1], t[3], t[4]), j);
+        uint32_t b = successeur(creer(t[1], t[2], t[4], t[5]), j);
+        uint32_t d = successeur(creer(t[3], t[4], t[6], t[7]), j);
+        uint32_t e = successeur(creer(t[4], t[5], t[7], t[8]), j);
+
+        if (interrompu) return AUCUN;
+
+        r = creer(a, b, d, e);
+
+    }
+
+    noeuds[n].resultat = r;
+    return r;
+
+}
+
+uint32_t HashLife::modifier(uint32_t n, int64_t x, int64_t y, bool etat) {
+
+    Noeud c = noeuds[n];
+
+    if (c.niveau == 0) return etat ? 1 : 0;
+
+    int64_t moitie = int64_t(1) << (c.niveau - 1);
+
+    if (y < moitie) {
+
+        if (x < moitie) c.nw = modifier(c.nw, x, y, etat);
+        else c.ne = modifier(c.ne, x - moitie, y, etat);
+
+    }
+
+    else {
+
+        if (x < moitie) c.sw = modifier(c.sw, x, y - moitie, etat);
+        else c.se = modifier(c.se, x - moitie, y - moitie, etat);
+
+    }
+
+    return creer(c.nw, c.ne, c.sw, c.se);
+
+}
+
+uint32_t HashLife::unir(uint32_t a, uint32_t b) {
+
+    if (a == b || noeuds[b].population == 0) return a;
+    if (noeuds[a].population == 0) return b;
+    if (noeuds[a].niveau == 0) return 1;
+
+    Noeud x = noeuds[a], y = noeuds[b];
+
+    return creer(unir(x.nw, y.nw), unir(x.ne, y.ne), unir(x.sw, y.sw), unir(x.se, y.se));
+
+}
+
+uint32_t HashLife::inserer(uint32_t n, int64_t x, int64_t y, uint32_t motif) {
+
+    Noeud c = noeuds[n];
+
+    if (c.niveau == noeuds[motif].niveau) return unir(n, motif);
+
+    int64_t moitie = int64_t(1) << (c.niveau - 1);
+
+    if (y < moitie) {
+
+        if (x < moitie) c.nw = inserer(c.nw, x, y, motif);
+        else c.ne = inserer(c.ne, x - moitie, y, motif);
+
+    }
+
+    else {
+
+        if (x < moitie) c.sw = inserer(c.sw, x, y - moitie, motif);
+        else c.se = inserer(c.se, x - moitie, y - moitie, motif);
+
+    }
+
+    return creer(c.nw, c.ne, c.sw, c.se);
+
+}
+
+bool HashLife::lire(uint32_t n, int64_t x, int64_t y) const {
+
+    while (noeuds[n].niveau > 0) {
+
+        const Noeud& c = noeuds[n];
+        if (c.population == 0) return false;
+
+        int64_t moitie = int64_t(1) << (c.niveau - 1);
+
+        if (y < moitie) n = x < moitie ? c.nw : c.ne;
+        else n = x < moitie ? c.sw : c.se;
+
+        if (x >= moitie) x -= moitie;
+        if (y >= moitie) y -= moitie;
+
+    }
+
+    return n == 1;
+
+}
+
+void HashLife::couvrir(int64_t x, int64_t y) {
+
+    while (true) {
+
+        int64_t moitie = int64_t(1) << (noeuds[racine].niveau - 1);
+        if (-moitie <= x && x < moitie && -moitie <= y && y < moitie) return;
+
+        racine = agrandir(racine);
+
+    }
+
+}
+
+bool HashLife::get_cell(int64_t row, int64_t col) const {
+
+    int64_t moitie = int64_t(1) << (noeuds[racine].niveau - 1);
+    if (row < -moitie || row >= moitie || col < -moitie || col >= moitie) return false;
+
+    return lire(racine, col + moitie, row + moitie);
+
+}
+
+void HashLife::set_cell(int64_t row, int64_t col, bool state) {
+
+    couvrir(col, row);
+
+    int64_t moitie = int64_t(1) << (noeuds[racine].niveau - 1);
+    racine = modifier(racine, col + moitie, row + moitie, state);
+
+}
+
+bool HashLife::avancer(int exposant, bool limite) {
+
+    // Le motif doit tenir dans le quart central avant d'avancer, sinon
+    // il pourrait sortir de la zone calculée
+    while (noeuds[racine].niveau < exposant + 2 || noeuds[centre(centre(racine))].population != noeuds[racine].population) {
+
+        racine = agrandir(racine);
+
+    }
+
+    borne = limite;
+    interrompu = false;
+
+    uint32_t suivante = successeur(agrandir(racine), exposant);
+
+    borne = false;
+    if (interrompu) return false;
+
+    racine = suivante;
+    if (memory() > limite_octets) garbage_collect();
+
+    return true;
+
+}
+
+void HashLife::step(int exposant) {
+
+    // Saut déjà trop grand pour la limite : suite de sauts qui tiennent
+    if (exposant > exposant_sur) {
+
+        for (uint64_t k = 0; k < (uint64_t(1) << (exposant - exposant_sur)); k ++) step(exposant_sur);
+        return;
+
+    }
+
+    // Les résultats mémorisés ne valent que pour un pas donné
+    if (exposant != exposant_memo) {
+
+        for (size_t i = 0; i < noeuds.size(); i ++) noeuds[i].resultat = AUCUN;
+        exposant_memo = exposant;
+
+    }
+
+    if (avancer(exposant, true)) return;
+
+    // Les résultats déjà mémorisés sont justes : on collecte et on reprend
+    garbage_collect();
+    if (avancer(exposant, true)) return;
+
+    garbage_collect();
+
+    // Une génération ne se coupe pas : le motif seul dépasse la limite
+    if (exposant == 0) {
+
+        avancer(0, false);
+        return;
+
+    }
+
+    exposant_sur = exposant - 1;
+    step(exposant - 1);
+    step(exposant - 1);
+
+}
+
+uint32_t HashLife::leaf(uint64_t bits) {
+
+    if (bits == 0) return vide(3);
+
+    auto connue = feuilles.find(bits);
+    if (connue != feuilles.end()) return connue->second;
+
+    auto cellule = [bits](int y, int x) -> uint32_t { return (bits >> (8 * y + x)) & 1; };
+
+    uint32_t niveau_1[4][4], niveau_2[2][2];
+
+    for (int y = 0; y < 4; y ++) {
+        for (int x = 0; x < 4; x ++) {
+
+            niveau_1[y][x] = creer(cellule(2 * y, 2 * x), cellule(2 * y, 2 * x + 1), cellule(2 * y + 1, 2 * x), cellule(2 * y + 1, 2 * x + 1));
+
+        }
+
+    }
+
+    for (int y = 0; y < 2; y ++) {
+        for (int x = 0; x < 2; x ++) {
+
+            niveau_2[y][x] = creer(niveau_1[2 * y][2 * x], niveau_1[2 * y][2 * x + 1], niveau_1[2 * y + 1][2 * x], niveau_1[2 * y + 1][2 * x + 1]);
+
+        }
+
+    }
+
+    uint32_t n = creer(niveau_2[0][0], niveau_2[0][1], niveau_2[1][0], niveau_2[1][1]);
+    feuilles[bits] = n;
+
+    return n;
+
+}
+
+uint32_t HashLife::block(const uint64_t* lignes) {
+
+    // 8 x 8 feuilles, puis trois niveaux d'assemblage jusqu'au niveau 6
+    uint32_t grille[8][8];
+
+    for (int by = 0; by < 8; by ++) {
+        for (int bx = 0; bx < 8; bx ++) {
+
+            uint64_t bits = 0;
+
+            for (int r = 0; r < 8; r ++) {
+
+                bits |= ((lignes[8 * by + r] >> (8 * bx)) & 0xFF) << (8 * r);
+
+            }
+
+            grille[by][bx] = leaf(bits);
+
+        }
+
+    }
+
+    for (int taille = 4; taille >= 1; taille /= 2) {
+        for (int y = 0; y < taille; y ++) {
+            for (int x = 0; x < taille; x ++) {
+
+                grille[y][x] = creer(grille[2 * y][2 * x], grille[2 * y][2 * x + 1], grille[2 * y + 1][2 * x], grille[2 * y + 1][2 * x + 1]);
+
+            }
+
+        }
+
+    }
+
+    return grille[0][0];
+
+}
+
+uint32_t HashLife::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+
+    return creer(nw, ne, sw, se);
+
+}
+
+uint32_t HashLife::empty(int niveau) {
+
+    return vide(niveau);
+
+}
+
+void HashLife::insert(uint32_t noeud, int64_t row, int64_t col) {
+
+    Noeud c = noeuds[noeud];
+    if (c.population == 0) return;
+
+    int64_t taille = int64_t(1) << c.niveau;
+
+    if ((row & (taille - 1)) || (col & (taille - 1))) {
+
+        int64_t moitie = taille / 2;
+
+        insert(c.nw, row, col);
+        insert(c.ne, row, col + moitie);
+        insert(c.sw, row + moitie, col);
+        insert(c.se, row + moitie, col + moitie);
+
+        return;
+
+    }
+
+    // Une racine qui contient les deux coins est forcément plus grande que
+    // le nœud et alignée sur lui
+    couvrir(col, row);
+    couvrir(col + taille - 1, row + taille - 1);
+
+    int64_t moitie = int64_t(1) << (noeuds[racine].niveau - 1);
+    racine = inserer(racine, col + moitie, row + moitie, noeud);
+
+}
+
+void HashLife::ecrire(FILE* fichier, uint32_t n, unordered_map<uint32_t, uint32_t>& numeros, uint32_t& suivant) const {
+
+    const Noeud& c = noeuds[n];
+    if (c.population == 0 || numeros.count(n)) return;
+
+    if (c.niveau == 3) {
+
+        // Lignes de '.' et '*' terminées par '$', sans les fins vides
+        char ligne[8 * 9 + 2];
+        int longueur = 0, fin_utile = 0;
+
+        for (int y = 0; y < 8; y ++) {
+
+            int derniere = -1;
+            for (int x = 0; x < 8; x ++) if (lire(n, x, y)) derniere = x;
+
+            for (int x = 0; x <= derniere; x ++) ligne[longueur++] = lire(n, x, y) ? '*' : '.';
+            ligne[longueur++] = '$';
+
+            if (derniere >= 0) fin_utile = longueur;
+
+        }
+
+        std::fprintf(fichier, "%.*s\n", fin_utile, ligne);
+
+    }
+
+    else {
+
+        const uint32_t enfants[4] = {c.nw, c.ne, c.sw, c.se};
+        for (uint32_t enfant : enfants) ecrire(fichier, enfant, numeros, suivant);
+
+        auto numero = [&](uint32_t enfant) { return noeuds[enfant].population ? numeros.at(enfant) : 0u; };
+
+        std::fprintf(fichier, "%d %u %u %u %u\n", c.niveau, numero(c.nw), numero(c.ne), numero(c.sw), numero(c.se));
+
+    }
+
+    numeros[n] = suivant++;
+
+}
+
+bool HashLife::save_macrocell(const string& chemin) const {
+
+    FILE* fichier = std::fopen(chemin.c_str(), "w");
+    if (!fichier) return false;
+
+    std::fprintf(fichier, "[M2] (game_of_life)\n#R B3/S23\n");
+
+    unordered_map<uint32_t, uint32_t> numeros;
+    uint32_t suivant = 1;
+
+    // Un motif vide s'écrit comme une feuille vide
+    if (noeuds[racine].population == 0) std::fprintf(fichier, "$\n");
+    else ecrire(fichier, racine, numeros, suivant);
+
+    return std::fclose(fichier) == 0;
+
+}
+
+void HashLife::marquer(uint32_t n, vector<bool>& marques) const {
+
+    vector<uint32_t> pile = {n};
+
+    while (!pile.empty()) {
+
+        uint32_t i = pile.back();
+        pile.pop_back();
+
+        if (i == AUCUN || marques[i]) continue;
+        marques[i] = true;
+
+        const Noeud& c = noeuds[i];
+        if (c.niveau == 0) continue;
+
+        pile.push_back(c.nw);
+        pile.push_back(c.ne);
+        pile.push_back(c.sw);
+        pile.push_back(c.se);
+        pile.push_back(c.resultat);
+
+    }
+
+}
+
+void HashLife::compacter(const vector<bool>& marques) {
+
+    // Les nœuds gardés ne font que descendre : nouveau[i] <= i
+    vector<uint32_t> nouveau(noeuds.size(), AUCUN);
+    uint32_t k = 0;
+
+    for (uint32_t i = 0; i < noeuds.size(); i ++) {
+
+        if (marques[i]) nouveau[i] = k++;
+
+    }
+
+    auto renommer = [&](uint32_t i) { return i == AUCUN ? AUCUN : nouveau[i]; };
+
+    for (uint32_t i = 0; i < noeuds.size(); i ++) {
+
+        if (!marques[i]) continue;
+
+        Noeud n = noeuds[i];
+        n.nw = renommer(n.nw);
+        n.ne = renommer(n.ne);
+        n.sw = renommer(n.sw);
+        n.se = renommer(n.se);
+        n.resultat = renommer(n.resultat);
+        noeuds[nouveau[i]] = n;
+
+    }
+
+    noeuds.truncate(k);
+    nb_vivants = k;
+
+    racine = nouveau[racine];
+    for (uint32_t& v : vides) v = nouveau[v];
+
+}
+
+void HashLife::garbage_collect() {
+
+    // Premier passage en gardant les résultats mémorisés accessibles ; s'il
+    // ne suffit pas, on les abandonne et on ne garde que le motif
+    for (int passage = 0; passage < 2; passage ++) {
+
+        vector<bool> marques(noeuds.size(), false);
+        marques[0] = marques[1] = true;
+
+        marquer(racine, marques);
+        for (uint32_t v : vides) marquer(v, marques);
+
+        compacter(marques);
+
+        // Table ramenée à la puissance de deux au-dessus des nœuds vivants
+        size_t taille = 1 << 16;
+        while (taille < nb_vivants) taille *= 2;
+
+        rehash(taille);
+        unordered_map<uint64_t, uint32_t>().swap(feuilles);
+        nb_collectes += 1;
+
+        if (memory() <= limite_octets / 2) return;
+
+        for (size_t i = 0; i < noeuds.size(); i ++) noeuds[i].resultat = AUCUN;
+
+    }
+
+}
+
+void HashLife::collecter(uint32_t n, int64_t x, int64_t y, int64_t r0, int64_t c0, int64_t r1, int64_t c1, vector<pair<int64_t, int64_t>>& sortie) const {
+
+    const Noeud& c = noeuds[n];
+    if (c.population == 0) return;
+
+    int64_t taille = int64_t(1) << c.niveau;
+    if (x >= c1 || y >= r1 || x + taille <= c0 || y + taille <= r0) return;
+
+    if (c.niveau == 0) {
+
+        sortie.push_back({y, x});
+        return;
+
+    }
+
+    int64_t moitie = taille / 2;
+
+    collecter(c.nw, x, y, r0, c0, r1, c1, sortie);
+    collecter(c.ne, x + moitie, y, r0, c0, r1, c1, sortie);
+    collecter(c.sw, x, y + moitie, r0, c0, r1, c1, sortie);
+    collecter(c.se, x + moitie, y + moitie, r0, c0, r1, c1, sortie);
+
+}
+
+void HashLife::cells(int64_t r0, int64_t c0, int64_t r1, int64_t c1, vector<pair<int64_t, int64_t>>& sortie) const {
+
+    int64_t moitie = int64_t(1) << (noeuds[racine].niveau - 1);
+
+    sortie.clear();
+    collecter(racine, -moitie, -moitie, r0, c0, r1, c1, sortie);
+
+}
+
+uint64_t HashLife::population() const {
+
+    return noeuds[racine].population;
+
+}
+
+size_t HashLife::node_count() const {
+
+    return nb_vivants;
+
+}
+
+size_t HashLife::memory() const {
+
+    // Ce qui est alloué, pas seulement ce qui est vivant ; pour le cache des
+    // feuilles, un seau par pointeur et un maillon par entrée
+    size_t octets = noeuds.capacity() * sizeof(Noeud) + table.capacity() * sizeof(uint32_t) + vides.capacity() * sizeof(uint32_t);
+    octets += feuilles.bucket_count() * sizeof(void*) + feuilles.size() * (sizeof(void*) + sizeof(pair<const uint64_t, uint32_t>));
+
+    return octets;
+
+}
+
+size_t HashLife::gc_count() const {
+
+    return nb_collectes;
+
+}
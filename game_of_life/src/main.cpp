@@ -2,9 +2,16 @@
 #include "game.h"
 using namespace std;
 
-int main() {
+int main(int argc, char* argv[]) {
     
     Game g = Game();
+
+    if (argc > 1 && !g.load_pattern(argv[1])) {
+
+        cerr << "Motif illisible : " << argv[1] << endl;
+
+    }
+
     g.run();
 
 }
\ No newline at end of file
@@ -0,0 +1,449 @@
+#include <cstdio>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "pattern.h"
+
+MappedFile::MappedFile() : donnees(nullptr), taille(0) {}
+
+MappedFile::~MappedFile() {
+
+    close();
+
+}
+
+bool MappedFile::open(const string& chemin) {
+
+    close();
+
+    int fd = ::open(chemin.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat infos;
+
+    if (fstat(fd, &infos) != 0 || infos.st_size == 0) {
+
+        ::close(fd);
+        return false;
+
+    }
+
+    void* carte = mmap(nullptr, infos.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (carte == MAP_FAILED) return false;
+
+    // Lu une seule fois du début à la fin
+    madvise(carte, infos.st_size, MADV_SEQUENTIAL);
+
+    donnees = static_cast<const char*>(carte);
+    taille = infos.st_size;
+
+    return true;
+
+}
+
+void MappedFile::close() {
+
+    if (donnees) munmap(const_cast<char*>(donnees), taille);
+
+    donnees = nullptr;
+    taille = 0;
+
+}
+
+const char* MappedFile::begin() const {
+
+    return donnees;
+
+}
+
+const char* MappedFile::end() const {
+
+    return donnees + taille;
+
+}
+
+static void passer_ligne(const char*& p, const char* fin) {
+
+    while (p < fin && *p != '\n') p ++;
+    if (p < fin) p ++;
+
+}
+
+static bool lire_entier(const char*& p, const char* fin, uint64_t& valeur) {
+
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) p ++;
+    if (p == fin || *p < '0' || *p > '9') return false;
+
+    // Saturé plutôt que repassé par zéro : un nombre trop grand reste trop grand
+    valeur = 0;
+
+    for (; p < fin && *p >= '0' && *p <= '9'; p ++) {
+
+        uint64_t chiffre = *p - '0';
+        valeur = valeur > (UINT64_MAX - chiffre) / 10 ? UINT64_MAX : valeur * 10 + chiffre;
+
+    }
+
+    return true;
+
+}
+
+static void passer_blancs(const char*& p, const char* fin) {
+
+    while (p < fin && (*p == ' ' || *p == '\t')) p ++;
+
+}
+
+static bool lire_symbole(const char*& p, const char* fin, char symbole) {
+
+    passer_blancs(p, fin);
+    if (p == fin || *p != symbole) return false;
+
+    p ++;
+    return true;
+
+}
+
+// Entête "x = largeur, y = hauteur[, rule = ..]" ; le reste de la ligne est ignoré
+static bool lire_entete(const char*& p, const char* fin, uint64_t& largeur, uint64_t& hauteur) {
+
+    if (!lire_symbole(p, fin, 'x') || !lire_symbole(p, fin, '=') || !lire_entier(p, fin, largeur)) return false;
+    if (!lire_symbole(p, fin, ',') || !lire_symbole(p, fin, 'y') || !lire_symbole(p, fin, '=') || !lire_entier(p, fin, hauteur)) return false;
+
+    passer_ligne(p, fin);
+
+    return largeur <= RLE_COTE_MAX && hauteur <= RLE_COTE_MAX;
+
+}
+
+// Bande de 64 lignes en cours : un bloc par colonne de blocs touchée
+class Bande {
+
+    private:
+
+        int64_t by;
+        unordered_map<int64_t, vector<uint64_t>> blocs;
+        const BlockSink& sortie;
+
+    public:
+
+        Bande(const BlockSink& sortie) : by(INT64_MIN), sortie(sortie) {}
+
+        void flush() {
+
+            for (auto& [bx, lignes] : blocs) sortie(by, bx, lignes.data());
+            blocs.clear();
+
+        }
+
+        // n cellules vivantes à partir de (y, x)
+        void run(int64_t y, int64_t x, int64_t n) {
+
+            int64_t b = y >> 6;
+
+            if (b != by) {
+
+                flush();
+                by = b;
+
+            }
+
+            while (n > 0) {
+
+                int64_t bx = x >> 6;
+                int debut = x & 63;
+                int longueur = static_cast<int>(std::min<int64_t>(n, 64 - debut));
+
+                vector<uint64_t>& lignes = blocs[bx];
+                if (lignes.empty()) lignes.assign(64, 0);
+
+                uint64_t masque = longueur == 64 ? ~uint64_t(0) : ((uint64_t(1) << longueur) - 1) << debut;
+                lignes[y & 63] |= masque;
+
+                x += longueur;
+                n -= longueur;
+
+            }
+
+        }
+
+};
+
+bool read_rle(const MappedFile& fichier, int64_t row, int64_t col, const BlockSink& bloc) {
+
+    const char* p = fichier.begin();
+    const char* fin = fichier.end();
+
+    if (!p) return false;
+
+    // Commentaires, puis l'entête obligatoire
+    while (p < fin && (*p == '#' || *p == '\n' || *p == '\r')) passer_ligne(p, fin);
+
+    uint64_t largeur, hauteur;
+    if (!lire_entete(p, fin, largeur, hauteur)) return false;
+
+    // Chaque compte est borné par ce qui reste de la boîte annoncée : un
+    // fichier qui en sort est refusé avant d'allouer quoi que ce soit.
+    // dx <= largeur et dy <= hauteur tout au long de la lecture
+    Bande bande(bloc);
+    int64_t y = row, x = col;
+    uint64_t dx = 0, dy = 0;
+
+    while (p < fin && *p != '!') {
+
+        uint64_t nombre = 1;
+        bool compte = lire_entier(p, fin, nombre);
+
+        if (p == fin) break;
+
+        char c = *p++;
+
+        if (c == '\n' || c == '\r' || c == ' ' || c == '\t') {
+
+            if (compte) return false;
+            continue;
+
+        }
+
+        if (c == '$') {
+
+            if (nombre > hauteur - dy) return false;
+
+            y += nombre;
+            dy += nombre;
+            x = col;
+            dx = 0;
+
+        }
+
+        else if (c == 'b' || c == '.') {
+
+            if (nombre > largeur - dx) return false;
+
+            x += nombre;
+            dx += nombre;
+
+        }
+
+        else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+
+            if (dy >= hauteur || nombre > largeur - dx) return false;
+
+            bande.run(y, x, nombre);
+            x += nombre;
+            dx += nombre;
+
+        }
+
+        else {
+
+            return false;
+
+        }
+
+    }
+
+    bande.flush();
+
+    return true;
+
+}
+
+bool read_macrocell(const MappedFile& fichier, vector<MacroNode>& noeuds) {
+
+    const char* p = fichier.begin();
+    const char* fin = fichier.end();
+
+    static const char ENTETE[] = "[M2]";
+
+    if (!p || fin - p < 4 || std::string(p, 4) != ENTETE) return false;
+
+    passer_ligne(p, fin);
+
+    // Indice 0 : nœud vide
+    noeuds.assign(1, MacroNode{0, {0, 0, 0, 0}, 0});
+
+    while (p < fin) {
+
+        char c = *p;
+
+        if (c == '#' || c == '\n' || c == '\r') {
+
+            passer_ligne(p, fin);
+            continue;
+
+        }
+
+        MacroNode noeud{3, {0, 0, 0, 0}, 0};
+
+        if (c == '.' || c == '*' || c == '$') {
+
+            int r = 0, x = 0;
+
+            for (; p < fin && *p != '\n'; p ++) {
+
+                if (*p == '$') {
+
+                    r += 1;
+                    x = 0;
+
+                }
+
+                else if (*p == '*' || *p == '.') {
+
+                    if (r >= 8 || x >= 8) return false;
+                    if (*p == '*') noeud.feuille |= uint64_t(1) << (8 * r + x);
+                    x += 1;
+
+                }
+
+            }
+
+            passer_ligne(p, fin);
+
+        }
+
+        else {
+
+            uint64_t valeurs[5];
+
+            for (uint64_t& valeur : valeurs) {
+
+                if (!lire_entier(p, fin, valeur)) return false;
+
+            }
+
+            noeud.niveau = static_cast<int>(valeurs[0]);
+            if (noeud.niveau < 4 || noeud.niveau > 62) return false;
+
+            for (int k = 0; k < 4; k ++) {
+
+                if (valeurs[k + 1] >= noeuds.size()) return false;
+
+                // Les enfants sont d'un niveau en dessous
+                const MacroNode& enfant = noeuds[valeurs[k + 1]];
+                if (valeurs[k + 1] && enfant.niveau != noeud.niveau - 1) return false;
+
+                noeud.enfants[k] = static_cast<uint32_t>(valeurs[k + 1]);
+
+            }
+
+            passer_ligne(p, fin);
+
+        }
+
+        noeuds.push_back(noeud);
+
+    }
+
+    return noeuds.size() > 1;
+
+}
+
+// Sortie RLE, lignes de 70 caractères au plus
+class EcrivainRle {
+
+    private:
+
+        FILE* fichier;
+        int colonne;
+
+    public:
+
+        EcrivainRle(FILE* fichier) : fichier(fichier), colonne(0) {}
+
+        void emit(int64_t nombre, char c) {
+
+            if (nombre <= 0) return;
+
+            char jeton[24];
+            int n = nombre > 1 ? std::snprintf(jeton, sizeof(jeton), "%lld%c", static_cast<long long>(nombre), c) : std::snprintf(jeton, sizeof(jeton), "%c", c);
+
+            if (colonne + n > 70) {
+
+                std::fputc('\n', fichier);
+                colonne = 0;
+
+            }
+
+            std::fputs(jeton, fichier);
+            colonne += n;
+
+        }
+
+};
+
+bool write_rle(const string& chemin, const vector<pair<int64_t, int64_t>>& cellules) {
+
+    FILE* fichier = std::fopen(chemin.c_str(), "w");
+    if (!fichier) return false;
+
+    int64_t r0 = 0, r1 = 0, c0 = 0, c1 = 0;
+
+    if (!cellules.empty()) {
+
+        r0 = cellules.front().first;
+        r1 = cellules.back().first + 1;
+        c0 = c1 = cellules.front().second;
+
+        for (auto [r, c] : cellules) {
+
+            c0 = std::min(c0, c);
+            c1 = std::max(c1, c + 1);
+
+        }
+
+    }
+
+    std::fprintf(fichier, "x = %lld, y = %lld, rule = B3/S23\n", static_cast<long long>(c1 - c0), static_cast<long long>(r1 - r0));
+
+    EcrivainRle rle(fichier);
+    int64_t ligne = r0, colonne = c0;
+    int64_t debut = c0, longueur = 0;
+
+    for (auto [r, c] : cellules) {
+
+        // Prolonge la série de cellules vivantes en cours
+        if (r == ligne && longueur && c == debut + longueur) {
+
+            longueur += 1;
+            continue;
+
+        }
+
+        rle.emit(longueur, 'o');
+        colonne = debut + longueur;
+        longueur = 0;
+
+        if (r > ligne) {
+
+            rle.emit(r - ligne, '$');
+            ligne = r;
+            colonne = c0;
+
+        }
+
+        rle.emit(c - colonne, 'b');
+        debut = c;
+        longueur = 1;
+
+    }
+
+    rle.emit(longueur, 'o');
+    rle.emit(1, '!');
+    std::fputc('\n', fichier);
+
+    return std::fclose(fichier) == 0;
+
+}
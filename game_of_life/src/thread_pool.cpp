@@ -0,0 +1,109 @@
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(unsigned nb_threads) : prochain(0), nb_elements(0), taille_bloc(1), actifs(0), generation(0), arret(false) {
+
+    // Le thread appelant participe au travail en tant que thread 0
+    for (unsigned id = 1; id < std::max(1u, nb_threads); id ++) {
+
+        threads.emplace_back(&ThreadPool::boucle, this, id);
+
+    }
+
+}
+
+ThreadPool::~ThreadPool() {
+
+    {
+        std::lock_guard<std::mutex> verrou(mutex);
+        arret = true;
+    }
+
+    travail_pret.notify_all();
+
+    for (auto& thread : threads) {
+
+        thread.join();
+
+    }
+
+}
+
+unsigned ThreadPool::size() const {
+
+    return threads.size() + 1;
+
+}
+
+void ThreadPool::executer(unsigned id) {
+
+    while (true) {
+
+        size_t debut = prochain.fetch_add(taille_bloc);
+        if (debut >= nb_elements) break;
+
+        tache(debut, std::min(debut + taille_bloc, nb_elements), id);
+
+    }
+
+}
+
+void ThreadPool::boucle(unsigned id) {
+
+    unsigned long vue = 0;
+
+    while (true) {
+
+        {
+            std::unique_lock<std::mutex> verrou(mutex);
+            travail_pret.wait(verrou, [&] { return arret || generation != vue; });
+            if (arret) return;
+            vue = generation;
+        }
+
+        executer(id);
+
+        std::lock_guard<std::mutex> verrou(mutex);
+        if (--actifs == 0) travail_fini.notify_one();
+
+    }
+
+}
+
+void ThreadPool::parallel_for(size_t n, size_t taille, std::function<void(size_t, size_t, unsigned)> f) {
+
+    // Un bloc vide n'avancerait jamais, sur un thread comme sur plusieurs
+    taille = std::max<size_t>(1, taille);
+
+    if (threads.empty() || n <= taille) {
+
+        for (size_t debut = 0; debut < n; debut += taille) {
+
+            f(debut, std::min(debut + taille, n), 0);
+
+        }
+
+        return;
+
+    }
+
+    {
+        std::lock_guard<std::mutex> verrou(mutex);
+        tache = std::move(f);
+        nb_elements = n;
+        taille_bloc = taille;
+        prochain = 0;
+        actifs = threads.size();
+        generation += 1;
+    }
+
+    travail_pret.notify_all();
+    executer(0);
+
+    std::unique_lock<std::mutex> verrou(mutex);
+    travail_fini.wait(verrou, [&] { return actifs == 0; });
+
+}